@@ -10,6 +10,8 @@
 //  the file LICENCE.GPL
 //=============================================================================
 
+#include <algorithm>
+
 #include "libmscore/xml.h"
 #include "libmscore/note.h"
 #include "libmscore/harmony.h"
@@ -404,6 +406,80 @@ void EventList::insert(const Event& e)
       append(e);
       }
 
+//---------------------------------------------------------
+//   EventMap::merge
+//    sort the pending events, and merge them in after the
+//    events already there with the same tick
+//---------------------------------------------------------
+
+void EventMap::merge() const
+      {
+      if (_sorted == _events.size())
+            return;
+      auto byTick = [](const value_type& a, const value_type& b) { return a.first < b.first; };
+      auto mid = _events.begin() + _sorted;
+      std::stable_sort(mid, _events.end(), byTick);
+      if (_sorted && byTick(*mid, *(mid - 1)))
+            std::inplace_merge(_events.begin(), mid, _events.end(), byTick);
+      _sorted = _events.size();
+      }
+
+//---------------------------------------------------------
+//   EventMap::append
+//    insert all events of other, in their insertion order,
+//    as if they were inserted one by one
+//---------------------------------------------------------
+
+void EventMap::append(const EventMap& other)
+      {
+      _events.insert(_events.end(), other._events.cbegin(), other._events.cend());
+      registerChannel(other._highestChannel);
+      }
+
+//---------------------------------------------------------
+//   EventMap::erase
+//---------------------------------------------------------
+
+EventMap::iterator EventMap::erase(const_iterator i)
+      {
+      merge();
+      --_sorted;
+      return _events.erase(i);
+      }
+
+EventMap::iterator EventMap::erase(const_iterator first, const_iterator last)
+      {
+      merge();
+      _sorted -= last - first;
+      return _events.erase(first, last);
+      }
+
+//---------------------------------------------------------
+//   EventMap::lower_bound
+//   EventMap::upper_bound
+//   EventMap::find
+//---------------------------------------------------------
+
+EventMap::const_iterator EventMap::lower_bound(int tick) const
+      {
+      merge();
+      return std::lower_bound(_events.cbegin(), _events.cend(), tick,
+         [](const value_type& v, int t) { return v.first < t; });
+      }
+
+EventMap::const_iterator EventMap::upper_bound(int tick) const
+      {
+      merge();
+      return std::upper_bound(_events.cbegin(), _events.cend(), tick,
+         [](int t, const value_type& v) { return t < v.first; });
+      }
+
+EventMap::const_iterator EventMap::find(int tick) const
+      {
+      const_iterator i = lower_bound(tick);
+      return (i != _events.cend() && i->first == tick) ? i : _events.cend();
+      }
+
 //---------------------------------------------------------
 //   class EventMap::fixupMIDI
 //---------------------------------------------------------
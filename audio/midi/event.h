@@ -14,6 +14,7 @@
 #define __EVENT_H__
 
 #include <map>
+#include <vector>
 
 namespace Ms {
 
@@ -340,13 +341,67 @@ class EventList : public QList<Event> {
       void insertNote(int channel, Note*);
       };
 
-class EventMap : public std::multimap<int, NPlayEvent> {
+//---------------------------------------------------------
+//   EventMap
+//    (u)tick -> event, like a std::multimap, but stored in one
+//    contiguous sorted array; events at the same tick keep their
+//    insertion order.
+//    insert() appends, the new events are sorted and merged in
+//    on the next access (begin(), lower_bound()...). Like a
+//    std::vector, this invalidates iterators, see PlayEventMap.
+//    The const accessors merge too: call merge() before a map
+//    is read from several threads.
+//---------------------------------------------------------
+
+class EventMap {
+   public:
+      typedef std::pair<int, NPlayEvent> value_type;
+      typedef std::vector<value_type>::iterator iterator;
+      typedef std::vector<value_type>::const_iterator const_iterator;
+
+   private:
+      mutable std::vector<value_type> _events;
+      mutable size_t _sorted = 0;       // _events[0, _sorted) is sorted, the rest is pending
       int _highestChannel = 15;
+
    public:
+      void merge() const;
+      void insert(const value_type& v)             { _events.push_back(v); }
+      template<class InputIt>
+      void insert(InputIt first, InputIt last)     { _events.insert(_events.end(), first, last); }
+      void append(const EventMap& other);
+      iterator erase(const_iterator i);
+      iterator erase(const_iterator first, const_iterator last);
+      void clear()                                 { _events.clear(); _sorted = 0; }
+      void reserve(size_t n)                       { _events.reserve(n); }
+
+      bool empty() const                           { return _events.empty(); }
+      size_t size() const                          { return _events.size(); }
+
+      iterator begin()                             { merge(); return _events.begin(); }
+      iterator end()                               { merge(); return _events.end(); }
+      const_iterator begin() const                 { merge(); return _events.cbegin(); }
+      const_iterator end() const                   { merge(); return _events.cend(); }
+      const_iterator cbegin() const                { return begin(); }
+      const_iterator cend() const                  { return end(); }
+
+      const_iterator lower_bound(int tick) const;
+      const_iterator upper_bound(int tick) const;
+      const_iterator find(int tick) const;
+      size_t count(int tick) const                 { return upper_bound(tick) - lower_bound(tick); }
+
       void fixupMIDI();
       void registerChannel(int c) { if (c > _highestChannel) _highestChannel = c; }
       };
 
+//---------------------------------------------------------
+//   PlayEventMap
+//    the sequencer playlist, its iterators stay valid
+//    when events are inserted during playback
+//---------------------------------------------------------
+
+typedef std::multimap<int, NPlayEvent> PlayEventMap;
+
 typedef EventList::iterator iEvent;
 typedef EventList::const_iterator ciEvent;
 
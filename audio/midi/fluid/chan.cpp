@@ -18,6 +18,8 @@
  * 02111-1307, USA
  */
 
+#include <algorithm>
+
 #include "fluid.h"
 #include "sfont.h"
 #include "gen.h"
@@ -35,6 +37,7 @@ Channel::Channel(Fluid* s, int num)
       _preset = 0;
       banknum = 0;
       prognum = 0;
+      std::fill(std::begin(keyVoices), std::end(keyVoices), nullptr);
       reset();
       }
 
@@ -251,7 +254,7 @@ void Channel::setPreset(Preset* p)
       {
       if (_preset != p) {
             if (p)
-                  p->loadSamples();
+                  p->loadSamples(synth);
             _preset = p;
             }
       }
@@ -21,6 +21,7 @@
 #include "fluid.h"
 #include "voice.h"
 #include "sfont.h"
+#include "audio/midi/simd.h"
 
 namespace FluidS {
 
@@ -299,6 +300,7 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
 //    4th order (cubic) interpolation.
 //    Returns number of samples processed (usually FLUID_BUFSIZE but could be
 //    smaller if end of sample occurs).
+//    The run between the loop/sample ends uses Ms::Simd::dot4().
 //-----------------------------------------------------------------------------
 
 int Voice::dsp_float_interpolate_4th_order(unsigned n)
@@ -367,10 +369,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
             /* interpolate the sequence of sample points */
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   coeffs = interp_coeff[fluid_phase_fract_to_tablerow (phase)];
-                  auto val = amp * (coeffs[0] * dsp_data[dsp_phase_index-1]
-                                   + coeffs[1] * dsp_data[dsp_phase_index]
-                                   + coeffs[2] * dsp_data[dsp_phase_index+1]
-                                   + coeffs[3] * dsp_data[dsp_phase_index+2]);
+                  auto val = amp * Ms::Simd::dot4(coeffs, &dsp_data[dsp_phase_index-1]);
                   dsp_buf[dsp_i] = val;
 
                   /* increment phase and amplitude */
@@ -448,6 +447,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
 //    7th order interpolation.
 //    Returns number of samples processed (usually FLUID_BUFSIZE but could be
 //    smaller if end of sample occurs).
+//    The run between the loop/sample ends uses Ms::Simd::dot7().
 //-----------------------------------------------------------------------------
 
 int Voice::dsp_float_interpolate_7th_order(unsigned n)
@@ -581,13 +581,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
             for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
                   coeffs = sinc_table7[fluid_phase_fract_to_tablerow (dsp_phase)];
 
-                  dsp_buf[dsp_i] = amp * (coeffs[0] * (float)dsp_data[dsp_phase_index-3]
-                     + coeffs[1] * (float)dsp_data[dsp_phase_index-2]
-                     + coeffs[2] * (float)dsp_data[dsp_phase_index-1]
-                     + coeffs[3] * (float)dsp_data[dsp_phase_index]
-                     + coeffs[4] * (float)dsp_data[dsp_phase_index+1]
-                     + coeffs[5] * (float)dsp_data[dsp_phase_index+2]
-                     + coeffs[6] * (float)dsp_data[dsp_phase_index+3]);
+                  dsp_buf[dsp_i] = amp * Ms::Simd::dot7(coeffs, &dsp_data[dsp_phase_index-3]);
 
                   /* increment phase and amplitude */
                   dsp_phase += dsp_phase_incr;
@@ -18,6 +18,8 @@
  * 02111-1307, USA
  */
 
+#include <algorithm>
+
 #include "fluid.h"
 #include "sfont.h"
 #include "conv.h"
@@ -38,6 +40,7 @@ namespace FluidS {
  */
 
 bool Fluid::initialized = false;
+QString Fluid::soundFontPath = "/MuseScore_General.sf3";
 
 /* better than a macro to determine inappropriate values for notes*/
 bool validNote(const int input) {
@@ -95,7 +98,6 @@ void Fluid::init(float sampleRate)
             }
       Synthesizer::init(sampleRate);
       sample_rate        = sampleRate;
-      sfont_id           = 0;
 
       _state       = FLUID_SYNTH_PLAYING; // as soon as the synth is created it starts playing.
       noteid      = 0;
@@ -121,19 +123,94 @@ Fluid::~Fluid()
       while (!mutex.tryLock()) {}
       qDeleteAll(activeVoices);
       qDeleteAll(freeVoices);
-      qDeleteAll(sfonts);
+      sfonts.clear();
       qDeleteAll(channel);
       qDeleteAll(patches);
       }
 
+//---------------------------------------------------------
+//   lowerStealPriority
+//    ordering of the stealing heap: a max-heap of this
+//    keeps the lowest priority (and, of equal ones, the
+//    first allocated voice) on top
+//---------------------------------------------------------
+
+bool Fluid::lowerStealPriority(const StealCandidate& a, const StealCandidate& b)
+      {
+      return a.prio > b.prio || (a.prio == b.prio && a.serial > b.serial);
+      }
+
 //---------------------------------------------------------
 //   freeVoice
 //---------------------------------------------------------
 
 void Fluid::freeVoice(Voice* v)
       {
-      if (activeVoices.removeOne(v))
-            freeVoices.append(v);
+      unindexVoice(v);
+      ++v->stealStamp;
+      int i = activeVoices.indexOf(v);
+      if (i < 0)
+            return;
+      if (processing) {
+            // keep the indices of process() valid
+            activeVoices[i] = nullptr;
+            voicesEnded = true;
+            }
+      else
+            activeVoices.removeAt(i);
+      freeVoices.append(v);
+      }
+
+//---------------------------------------------------------
+//   indexVoice
+//    add the started voice to the list of its key,
+//    see Channel::keyVoices
+//---------------------------------------------------------
+
+void Fluid::indexVoice(Voice* v)
+      {
+      if (v->keyIndexed || !v->channel)
+            return;
+      Voice*& head = v->channel->keyVoices[v->key];
+      v->prevSameKey = nullptr;
+      v->nextSameKey = head;
+      if (head)
+            head->prevSameKey = v;
+      head = v;
+      v->keyIndexed = true;
+      }
+
+//---------------------------------------------------------
+//   unindexVoice
+//---------------------------------------------------------
+
+void Fluid::unindexVoice(Voice* v)
+      {
+      if (!v->keyIndexed)
+            return;
+      if (v->prevSameKey)
+            v->prevSameKey->nextSameKey = v->nextSameKey;
+      else
+            v->channel->keyVoices[v->key] = v->nextSameKey;
+      if (v->nextSameKey)
+            v->nextSameKey->prevSameKey = v->prevSameKey;
+      v->prevSameKey = nullptr;
+      v->nextSameKey = nullptr;
+      v->keyIndexed = false;
+      }
+
+//---------------------------------------------------------
+//   voiceChanged
+//    the stealing priority of v may have changed
+//---------------------------------------------------------
+
+void Fluid::voiceChanged(Voice* v)
+      {
+      ++v->stealStamp;
+      if (stealHeapValid) {
+            stealHeap.push_back({ stealPriority(v), v->serial, v, v->stealStamp });
+            std::push_heap(stealHeap.begin(), stealHeap.end(), lowerStealPriority);
+            }
       }
 
 //---------------------------------------------------------
@@ -160,7 +237,7 @@ void Fluid::play(const PlayEvent& event)
                   //
                   // process note off
                   //
-                  for (Voice* v : qAsConst(activeVoices)) {
+                  for (Voice* v = cp->keyVoices[key]; v; v = v->nextSameKey) {
                         if (v->ON() && (v->chan == ch) && (v->key == key))
                               v->noteoff();
                         }
@@ -180,7 +257,7 @@ void Fluid::play(const PlayEvent& event)
                    * several voice processes, for example a stereo sample.  Don't
                    * release those...
                    */
-                  for(Voice* v : qAsConst(activeVoices)) {
+                  for (Voice* v = cp->keyVoices[key]; v; v = v->nextSameKey) {
                         if (v->isPlaying() && (v->chan == ch) && (v->key == key) && (v->get_id() != noteid))
                               v->noteoff();
                         }
@@ -361,11 +438,9 @@ void Fluid::setFromKeyPortamento(int chan, int defaultValue) {
  */
 Preset* Fluid::get_preset(unsigned int sfontnum, unsigned banknum, unsigned prognum)
       {
-      SFont* sf = get_sfont_by_id(sfontnum);
-      if (sf) {
-            Preset* preset = sf->get_preset(banknum, prognum);
-            if (preset != 0)
-                  return preset;
+      for (int i = 0; i < sfonts.size(); ++i) {
+            if (sfonts[i]->id() == int(sfontnum))
+                  return sfonts[i]->get_preset(int(banknum) - bankOffsets[i], prognum);
             }
       return 0;
       }
@@ -376,14 +451,33 @@ Preset* Fluid::get_preset(unsigned int sfontnum, unsigned banknum, unsigned prog
 
 Preset* Fluid::find_preset(unsigned banknum, unsigned prognum)
       {
-      for (SFont* sf : qAsConst(sfonts)) {
-            Preset* preset = sf->get_preset(banknum, prognum);
+      for (int i = 0; i < sfonts.size(); ++i) {
+            Preset* preset = sfonts[i]->get_preset(int(banknum) - bankOffsets[i], prognum);
             if (preset)
                   return preset;
             }
       return 0;
       }
 
+//---------------------------------------------------------
+//   prefetchPrograms
+//    load the samples of the (bank, program) presets before
+//    synthesis starts, instead of one preset at a time when
+//    a channel selects it; SF3 samples are decoded in parallel
+//---------------------------------------------------------
+
+void Fluid::prefetchPrograms(const std::vector<std::pair<int, int>>& banksPrograms)
+      {
+      QHash<SFont*, std::vector<Sample*>> samples;
+      for (const auto& bp : banksPrograms) {
+            Preset* preset = find_preset(bp.first, bp.second);
+            if (preset)
+                  preset->collectSamples(&samples[preset->sfont]);
+            }
+      for (auto i = samples.begin(); i != samples.end(); ++i)
+            i.key()->loadSamples(i.value());
+      }
+
 //---------------------------------------------------------
 //   program_change
 //---------------------------------------------------------
@@ -457,81 +551,105 @@ void Fluid::update_presets()
 void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
       {
       if (mutex.tryLock()) {
-            //we have to copy voices array for proper output sound processing in for loop
-            auto tempVoices = activeVoices;
-            for (Voice* v : tempVoices)
-                  v->write(len, out, effect1, effect2);
+            // voices ending in write() are removed after the loop, see freeVoice()
+            processing = true;
+            for (int i = 0; i < activeVoices.size(); ++i) {
+                  if (Voice* v = activeVoices[i])
+                        v->write(len, out, effect1, effect2);
+                  }
+            processing = false;
+            if (voicesEnded) {
+                  activeVoices.removeAll(nullptr);
+                  voicesEnded = false;
+                  }
+            // the envelopes moved on
+            stealHeapValid = false;
+            stealHeap.clear();
             mutex.unlock();
             }
       }
 
+//---------------------------------------------------------
+//   stealPriority
+//    how 'important' a voice is.
+//    The age is counted from the voice id instead of from
+//    noteid - id, which shifts every voice by the same
+//    amount, so the heap stays ordered when noteid grows.
+//---------------------------------------------------------
+
+double Fluid::stealPriority(const Voice* v) const
+      {
+      /* Start with an arbitrary number */
+      double prio = 10000.;
+
+      /* Is this voice on the drum channel?
+       * Then it is very important.
+       * Also, forget about the released-note condition:
+       * Typically, drum notes are triggered only very briefly, they run most
+       * of the time in release phase.
+       */
+      if (v->chan == 9)
+            prio += 4000;
+      else if (v->RELEASED()) {
+            /* The key for this voice has been released. Consider it much less important
+            * than a voice, which is still held.
+            */
+            prio -= 2000.;
+            }
+
+      if (v->SUSTAINED()) {
+        /* The sustain pedal is held down on this channel.
+         * Consider it less important than non-sustained channels.
+         * This decision is somehow subjective. But usually the sustain pedal
+         * is used to play 'more-voices-than-fingers', so it shouldn't hurt
+         * if we kill one voice.
+         */
+            prio -= 1000;
+            }
+
+      /* We are not enthusiastic about releasing voices, which have just been started.
+       * Otherwise hitting a chord may result in killing notes belonging to that very same
+       * chord.
+       * So subtract the age of the voice from the priority - an older voice is just a little
+       * bit less important than a younger voice. */
+      prio += v->get_id();
+
+      /* take a rough estimate of loudness into account. Louder voices are more important. */
+      if (v->volenv_section != FLUID_VOICE_ENVATTACK)
+            prio += v->volenv_val * 1000.;
+      return prio;
+      }
+
 /*
  * fluid_synth_free_voice_by_kill
  *
  * selects a voice for killing. the selection algorithm is a refinement
  * of the algorithm previously in fluid_synth_alloc_voice.
+ *
+ * The voices are kept in a heap by stealPriority(), so the repeated
+ * steals of a dense chord do not scan all voices each. The heap is
+ * built on the first steal after process(), and voiceChanged() adds
+ * the voices whose priority changed until the next process().
  */
 
 void Fluid::free_voice_by_kill()
       {
-      float best_prio = 999999.;
-      float this_voice_prio;
-      Voice* best_voice = 0;
-
-      for(Voice* v : qAsConst(activeVoices)) {
-            /* Determine, how 'important' a voice is.
-             * Start with an arbitrary number */
-            this_voice_prio = 10000.;
-
-            /* Is this voice on the drum channel?
-             * Then it is very important.
-             * Also, forget about the released-note condition:
-             * Typically, drum notes are triggered only very briefly, they run most
-             * of the time in release phase.
-             */
-            if (v->chan == 9) {
-                  this_voice_prio += 4000;
-
-                  }
-            else if (v->RELEASED()) {
-                  /* The key for this voice has been released. Consider it much less important
-                  * than a voice, which is still held.
-                  */
-                  this_voice_prio -= 2000.;
-                  }
-
-            if (v->SUSTAINED()) {
-              /* The sustain pedal is held down on this channel.
-               * Consider it less important than non-sustained channels.
-               * This decision is somehow subjective. But usually the sustain pedal
-               * is used to play 'more-voices-than-fingers', so it shouldn't hurt
-               * if we kill one voice.
-               */
-                  this_voice_prio -= 1000;
-                  }
-
-            /* We are not enthusiastic about releasing voices, which have just been started.
-             * Otherwise hitting a chord may result in killing notes belonging to that very same
-             * chord.
-             * So subtract the age of the voice from the priority - an older voice is just a little
-             * bit less important than a younger voice.
-             * This is a number between roughly 0 and 100.*/
-
-            this_voice_prio -= (noteid - v->get_id());
-
-            /* take a rough estimate of loudness into account. Louder voices are more important. */
-            if (v->volenv_section != FLUID_VOICE_ENVATTACK) {
-                  this_voice_prio += v->volenv_val * 1000.;
-                  }
-
-            /* check if this voice has less priority than the previous candidate. */
-            if (this_voice_prio < best_prio) {
-                  best_voice = v;
-                  best_prio = this_voice_prio;
+      if (!stealHeapValid) {
+            stealHeap.clear();
+            for (Voice* v : qAsConst(activeVoices))
+                  stealHeap.push_back({ stealPriority(v), v->serial, v, v->stealStamp });
+            std::make_heap(stealHeap.begin(), stealHeap.end(), lowerStealPriority);
+            stealHeapValid = true;
+            }
+      while (!stealHeap.empty()) {
+            std::pop_heap(stealHeap.begin(), stealHeap.end(), lowerStealPriority);
+            const StealCandidate c = stealHeap.back();
+            stealHeap.pop_back();
+            if (c.stamp == c.voice->stealStamp) {     // otherwise outdated, or freed
+                  c.voice->off();
+                  return;
                   }
             }
-      if (best_voice)
-            best_voice->off();
       }
 
 //---------------------------------------------------------
@@ -553,6 +671,7 @@ Voice* Fluid::alloc_voice(unsigned id, Sample* sample, int chan, int key, int ve
 
       Voice* v = freeVoices.takeLast();
       activeVoices.append(v);
+      v->serial = voiceSerial++;
 
       if (chan >= 0)
             c = channel[chan];
@@ -616,6 +735,7 @@ void Fluid::start_voice(Voice* voice)
                   }
             }
       voice->voice_start();
+      indexVoice(voice);
       }
 
 //---------------------------------------------------------
@@ -627,10 +747,11 @@ void Fluid::updatePatchList()
       qDeleteAll(patches);
       patches.clear();
 
+      bankOffsets.clear();
       int bankOffset = 0;
       int sfid = 0;
-      for (SFont* sf : qAsConst(sfonts)) {
-            sf->setBankOffset(bankOffset);
+      for (const QSharedPointer<SFont>& sf : qAsConst(sfonts)) {
+            bankOffsets.append(bankOffset);
             int banks = 0;
             for (Preset* p : sf->getPresets()) {
                   MidiPatch* patch = new MidiPatch;
@@ -661,7 +782,7 @@ void Fluid::updatePatchList()
 QStringList Fluid::soundFonts() const
       {
       QStringList sf;
-      for (SFont* f : sfonts)
+      for (const QSharedPointer<SFont>& f : sfonts)
             sf.append(QFileInfo(f->get_name()).fileName());
       return sf;
       }
@@ -674,7 +795,7 @@ std::vector<SoundFontInfo> Fluid::soundFontsInfo() const
       {
       std::vector<SoundFontInfo> sl;
       sl.reserve(sfonts.size());
-      for (SFont* f : sfonts)
+      for (const QSharedPointer<SFont>& f : sfonts)
             sl.emplace_back(QFileInfo(f->get_name()).fileName(), f->fontName());
       return sl;
       }
@@ -696,7 +817,8 @@ bool Fluid::loadSoundFonts(const QStringList& sl)
             v->off();
       for(Channel* c : qAsConst(channel))
             c->reset();
-      for (SFont* sf : qAsConst(sfonts))
+      const QList<QSharedPointer<SFont>> loaded = sfonts;
+      for (const QSharedPointer<SFont>& sf : loaded)
             sfunload(sf->id());
       locker.unlock();
       bool ok = true;
@@ -764,6 +886,8 @@ bool Fluid::removeSoundFont(const QString& s)
 
 //---------------------------------------------------------
 //   sfload
+//    the font is parsed only if no other instance has
+//    loaded the file before (see SFont::shared())
 //---------------------------------------------------------
 
 int Fluid::sfload(const QString& filename)
@@ -771,21 +895,9 @@ int Fluid::sfload(const QString& filename)
       if (filename.isEmpty())
             return -1;
 
-      SFont* sf = new SFont(this);
-      try {
-            if (!sf->read(filename)) {
-                  delete sf;
-                  sf = 0;
-                  return -1;
-                  }
-            }
-      catch(...) {
-            delete sf;
-            sf = 0;
+      QSharedPointer<SFont> sf = SFont::shared(filename, this);
+      if (!sf)
             return -1;
-            }
-
-      sf->setId(++sfont_id);
 
       /* insert the sfont as the first one on the list */
       sfonts.prepend(sf);
@@ -802,18 +914,15 @@ int Fluid::sfload(const QString& filename)
 
 bool Fluid::sfunload(int id)
       {
-      SFont* sf = get_sfont_by_id(id);
-
-      if (!sf) {
-            qDebug("No SoundFont with id = %d", id);
-            return false;
+      for (int i = 0; i < sfonts.size(); ++i) {
+            if (sfonts[i]->id() == id) {
+                  sfonts.removeAt(i);     // the font is freed with its last user (or the cache)
+                  updatePatchList();
+                  return true;
+                  }
             }
-
-      sfonts.removeAll(sf);   // remove the SoundFont from the list
-      updatePatchList();
-
-      delete sf;
-      return true;
+      qDebug("No SoundFont with id = %d", id);
+      return false;
       }
 
 //---------------------------------------------------------
@@ -822,9 +931,9 @@ bool Fluid::sfunload(int id)
 
 SFont* Fluid::get_sfont_by_id(int id)
       {
-      for(SFont* sf : qAsConst(sfonts)) {
+      for (const QSharedPointer<SFont>& sf : qAsConst(sfonts)) {
             if (sf->id() == id)
-                  return sf;
+                  return sf.data();
             }
       return 0;
       }
@@ -835,9 +944,9 @@ SFont* Fluid::get_sfont_by_id(int id)
 
 SFont* Fluid::get_sfont_by_name(const QString& name)
       {
-      for(SFont* sf : qAsConst(sfonts)) {
+      for (const QSharedPointer<SFont>& sf : qAsConst(sfonts)) {
             if (QFileInfo(sf->get_name()).fileName() == name)
-                  return sf;
+                  return sf.data();
             }
       return 0;
       }
@@ -974,7 +1083,7 @@ static void collectFiles(QFileInfoList* l, const QString& path)
 QFileInfoList Fluid::sfFiles()
       {
       QFileInfoList l;
-      l.append(QFileInfo("/MuseScore_General.sf3"));
+      l.append(QFileInfo(soundFontPath));
 
 #if 0
       QStringList pl = preferences.getString(PREF_APP_PATHS_MYSOUNDFONTS).split(";");
@@ -993,4 +1102,13 @@ QFileInfoList Fluid::sfFiles()
 #endif
       return l;
       }
+
+//---------------------------------------------------------
+//   clearSoundFontCache
+//---------------------------------------------------------
+
+void Fluid::clearSoundFontCache()
+      {
+      SFont::clearCache();
+      }
 }
@@ -258,6 +258,11 @@ class Channel {
        */
       char gen_abs[GEN_LAST];
 
+      /* The started voices of every key, linked by Voice::nextSameKey,
+       * so that note on/off events do not have to scan all voices
+       * (see Fluid::indexVoice()). */
+      Voice* keyVoices[256];
+
    public:
       Channel(Fluid* synth, int num);
 
@@ -302,11 +307,27 @@ enum {
 //---------------------------------------------------------
 
 class Fluid : public Synthesizer {
-      QList<SFont*> sfonts;               // the loaded soundfonts
+      QList<QSharedPointer<SFont>> sfonts;      // the loaded soundfonts, shared with other instances
+      QList<int> bankOffsets;                   // of sfonts, set by updatePatchList()
       QList<MidiPatch*> patches;
 
       QList<Voice*> freeVoices;           // unused synthesis processes
-      QList<Voice*> activeVoices;         // active synthesis processes
+      QList<Voice*> activeVoices;         // active synthesis processes, in the order they were allocated
+      bool processing = false;            // in process(): freeVoice() only clears the slot in activeVoices
+      bool voicesEnded = false;           // slots were cleared, remove them after process()
+
+      // the voice stealing candidates of free_voice_by_kill(), lowest priority first
+      struct StealCandidate {
+            double prio;
+            unsigned serial;
+            Voice* voice;
+            unsigned stamp;               // outdated if != voice->stealStamp
+            };
+      std::vector<StealCandidate> stealHeap;
+      bool stealHeapValid = false;        // built on demand, invalid after process()
+      unsigned voiceSerial = 0;           // the allocation order of the voices
+      double stealPriority(const Voice*) const;
+      static bool lowerStealPriority(const StealCandidate& a, const StealCandidate& b);
       QString _error;                     // last error message
 
       static bool initialized;
@@ -330,15 +351,13 @@ class Fluid : public Synthesizer {
    protected:
       int _state;                         // the synthesizer state
 
-      unsigned int sfont_id;
-
       QList<Channel*> channel;            // the channels
 
       unsigned int noteid;                // the id is incremented for every new note. it's used for noteoff's
 
       SFont* get_sfont_by_name(const QString& name);
       SFont* get_sfont_by_id(int id);
-      SFont* get_sfont(int idx) const     { return sfonts[idx];   }
+      SFont* get_sfont(int idx) const     { return sfonts[idx].data(); }
       bool sfunload(int id);
       int sfload(const QString& filename);
 
@@ -366,6 +385,7 @@ class Fluid : public Synthesizer {
 
       Preset* get_preset(unsigned int sfontnum, unsigned int banknum, unsigned int prognum);
       Preset* find_preset(unsigned int banknum, unsigned int prognum);
+      void prefetchPrograms(const std::vector<std::pair<int, int>>& banksPrograms);
       void modulate_voices(int chan, bool is_cc, int ctrl);
       void modulate_voices_all(int chan);
       void damp_voices(int chan);
@@ -404,6 +424,7 @@ class Fluid : public Synthesizer {
       void free_voice_by_kill();
 
       virtual void process(unsigned len, float* out, float* effect1, float* effect2);
+      int activeVoiceCount() const { return activeVoices.size(); }
 
       bool program_select(int chan, unsigned sfont_id, unsigned bank_num, unsigned preset_num);
       void get_program(int chan, unsigned* sfont_id, unsigned* bank_num, unsigned* preset_num);
@@ -415,6 +436,9 @@ class Fluid : public Synthesizer {
       void get_pitch_bend(int chan, int* ppitch_bend);
 
       void freeVoice(Voice* v);
+      void voiceChanged(Voice* v);
+      void indexVoice(Voice* v);
+      void unindexVoice(Voice* v);
 
       double getPitch(int k) const   { return _tuning[k]; }
       float ct2hz_real(float cents)  { return powf(2.0f, (cents - 6900.0f) / 1200.0f) * _masterTuning; }
@@ -429,7 +453,9 @@ class Fluid : public Synthesizer {
 
       // virtual SynthesizerGui* gui();
 
+      static QString soundFontPath;       // the soundfont to load, see sfFiles()
       static QFileInfoList sfFiles();
+      static void clearSoundFontCache();  // parse the soundfonts again on next load
 
       bool globalTerminate() { return _globalTerminate; }
       void setGlobalTerminate(bool terminate = true) { _globalTerminate = terminate; }
@@ -21,6 +21,8 @@
  * 02111-1307, USA
  */
 
+#include <algorithm>
+
 #include "sfont.h"
 #include "fluid.h"
 #include "voice.h"
@@ -28,6 +30,7 @@
 // #define DEBUG_SFONT
 
 #include "libmscore/xml.h"
+#include "libmscore/taskpool.h"
 
 static bool debugMode = false;
 
@@ -47,13 +50,12 @@ SFVersion::SFVersion()
 //   SFont
 //---------------------------------------------------------
 
-SFont::SFont(Fluid* f)
+SFont::SFont()
       {
-      synth       = f;
+      static QAtomicInt lastId;
       samplepos   = 0;
       samplesize  = 0;
-      _id         = 0;
-      _bankOffset = 0;
+      _id         = lastId.fetchAndAddRelaxed(1) + 1;
       }
 
 SFont::~SFont()
@@ -71,15 +73,77 @@ SFont::~SFont()
             }
       }
 
+//---------------------------------------------------------
+//   SFontCache
+//    the parsed soundfonts by absolute path, with the size
+//    and modification time of the file they were read from
+//---------------------------------------------------------
+
+struct SFontCacheEntry {
+      qint64 size;
+      QDateTime modified;
+      QSharedPointer<SFont> sf;
+      };
+
+static QMutex sfontCacheMutex;
+static QHash<QString, SFontCacheEntry> sfontCache;
+
+//---------------------------------------------------------
+//   shared
+//    the parsed soundfont of the file, read only once and
+//    kept in a process wide cache (until the file changes
+//    or clearCache()), so new synthesizer instances do not
+//    parse the file and decode the samples again.
+//    Returns a null pointer on error.
+//---------------------------------------------------------
+
+QSharedPointer<SFont> SFont::shared(const QString& file, Fluid* synth)
+      {
+      const QFileInfo fi(file);
+      const QString path = fi.absoluteFilePath();
+
+      QMutexLocker locker(&sfontCacheMutex);
+      auto i = sfontCache.find(path);
+      if (i != sfontCache.end()) {
+            if (i->size == fi.size() && i->modified == fi.lastModified())
+                  return i->sf;
+            sfontCache.erase(i);    // the file was replaced, synthesizers using the old font keep it
+            }
+
+      QSharedPointer<SFont> sf(new SFont);
+      try {
+            if (!sf->read(file, synth))
+                  return QSharedPointer<SFont>();
+            }
+      catch(...) {
+            return QSharedPointer<SFont>();
+            }
+      sfontCache.insert(path, SFontCacheEntry { fi.size(), fi.lastModified(), sf });
+      return sf;
+      }
+
+//---------------------------------------------------------
+//   clearCache
+//    the fonts are freed with the last synthesizer
+//    using them
+//---------------------------------------------------------
+
+void SFont::clearCache()
+      {
+      QMutexLocker locker(&sfontCacheMutex);
+      sfontCache.clear();
+      }
+
 //---------------------------------------------------------
 //   read
 //---------------------------------------------------------
 
-bool SFont::read(const QString& s)
+bool SFont::read(const QString& s, Fluid* synth)
       {
       f.setFileName(s);
       if (!load())
             return false;
+      mapSamples();
 
       synth->setLoadProgress(0);
       for (auto instrument : qAsConst(instruments)) {
@@ -100,13 +164,56 @@ bool SFont::read(const QString& s)
       return true;
       }
 
+//---------------------------------------------------------
+//   mapSamples
+//    map the 16 bit PCM sample data of a SF2 file, so
+//    Sample::load() points into it instead of reading and
+//    copying each sample. Not for SF3 (Ogg Vorbis samples
+//    are decoded anyway), big endian hosts (the samples
+//    would need swapping) or wasm, where the file already
+//    is in memory, and mapping it would copy all of it.
+//---------------------------------------------------------
+
+void SFont::mapSamples()
+      {
+#ifndef Q_OS_WASM
+      if (_version.major != 2 || QSysInfo::ByteOrder != QSysInfo::LittleEndian)
+            return;
+      if (samplesize == 0 || samplepos % sizeof(short))
+            return;
+      mapFile.setFileName(f.fileName());
+      if (!mapFile.open(QIODevice::ReadOnly))
+            return;
+      mappedSamples = mapFile.map(samplepos, samplesize);
+      if (!mappedSamples)
+            qDebug("SFont: cannot map <%s>, reading the samples instead", qPrintable(f.fileName()));
+#endif
+      }
+
+//---------------------------------------------------------
+//   loadSamples
+//    load the samples not loaded yet, SF3 samples are
+//    decoded on the TaskPool workers
+//---------------------------------------------------------
+
+void SFont::loadSamples(std::vector<Sample*> samples)
+      {
+      QMutexLocker locker(&sampleMutex);
+      std::sort(samples.begin(), samples.end());
+      samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+      samples.erase(std::remove_if(samples.begin(), samples.end(), [](Sample* s) { return !s->valid() || s->data; }), samples.end());
+      // each Sample::load() only writes its own sample
+      Ms::TaskPool::instance()->parallelFor(int(samples.size()), [&samples](int i) {
+            samples[i]->load();
+            });
+      }
+
 //---------------------------------------------------------
 //   get_preset
 //---------------------------------------------------------
 
 Preset* SFont::get_preset(int bank, int num)
       {
-      bank -= _bankOffset;
       for (Preset* p : qAsConst(presets)) {
             if ((p->get_banknum() == bank) && (p->get_num() == num))
                   return p;
@@ -143,9 +250,10 @@ Preset::~Preset()
 //    channel
 //---------------------------------------------------------
 
-void Preset::loadSamples()
+void Preset::loadSamples(Fluid* synth)
       {
-      bool locked = sfont->synth->mutex.tryLock();
+      bool locked = synth->mutex.tryLock();
+      QMutexLocker sampleLocker(&sfont->sampleMutex);
 
       if (_global_zone && _global_zone->instrument) {
             Instrument* i = _global_zone->instrument;
@@ -159,15 +267,15 @@ void Preset::loadSamples()
       int currentInstrZone = 0;
       float instrSize = (float)zones.size(); //float is used to properly calculate progress
       for (Zone* z : qAsConst(zones)) {
-            sfont->synth->setLoadProgress(currentInstrZone++ / instrSize * 100);
+            synth->setLoadProgress(currentInstrZone++ / instrSize * 100);
             Instrument* i = z->instrument;
             if (i->global_zone && i->global_zone->sample)
                   i->global_zone->sample->load();
 
             for (Zone* iz : qAsConst(i->zones)) {
-                  if (sfont->synth->globalTerminate()) {
+                  if (synth->globalTerminate()) {
                         if (locked)
-                              sfont->synth->mutex.unlock();
+                              synth->mutex.unlock();
                         return;
                   }
 
@@ -176,7 +284,26 @@ void Preset::loadSamples()
             }
 
       if (locked)
-            sfont->synth->mutex.unlock();
+            synth->mutex.unlock();
+      }
+
+//---------------------------------------------------------
+//   collectSamples
+//    the samples of all zones, as loaded by loadSamples()
+//---------------------------------------------------------
+
+void Preset::collectSamples(std::vector<Sample*>* samples) const
+      {
+      auto collect = [samples](const Instrument* i) {
+            if (i->global_zone && i->global_zone->sample)
+                  samples->push_back(i->global_zone->sample);
+            for (Zone* iz : i->zones)
+                  samples->push_back(iz->sample);
+            };
+      if (_global_zone && _global_zone->instrument)
+            collect(_global_zone->instrument);
+      for (Zone* z : zones)
+            collect(z->instrument);
       }
 
 //---------------------------------------------------------
@@ -622,7 +749,8 @@ Sample::Sample(SFont* s)
 
 Sample::~Sample()
       {
-      delete[] data;
+      if (_ownsData)
+            delete[] data;
       }
 
 //---------------------------------------------------------
@@ -633,6 +761,17 @@ void Sample::load()
       {
       if (!_valid || data)
             return;
+      if (!(sampletype & FLUID_SAMPLETYPE_OGG_VORBIS) && sf->mappedSampleData() && end * sizeof(short) <= sf->getSamplesize()) {
+            // nothing to read, the data is paged in as it is played
+            data      = sf->mappedSampleData() + start;
+            _ownsData = false;
+            end       -= (start + 1);       // marks last sample, contrary to SF spec.
+            loopstart -= start;
+            loopend   -= start;
+            start      = 0;
+            optimize();
+            return;
+            }
       QFile fd(sf->get_name());
       if (!fd.open(QIODevice::ReadOnly))
             return;
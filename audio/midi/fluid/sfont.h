@@ -47,20 +47,24 @@ struct SFVersion {            // version structure
 
 //---------------------------------------------------------
 //   SFont
+//    parsed presets, zones and samples, read only once
+//    loaded and shared by all synthesizer instances
+//    (see shared())
 //---------------------------------------------------------
 
 class SFont {
-      Fluid* synth;
       QFile f;
       unsigned samplepos;           // the position in the file at which the sample data starts
       unsigned samplesize;          // the size of the sample data
+      QFile mapFile;
+      uchar* mappedSamples { 0 };   // the SF2 sample data, mapped from the file (see mapSamples())
 
       QList<Instrument*> instruments;
       QList<Preset*> presets;
       QList<Sample*> sample;
 
-      int _id;
-      int _bankOffset;
+      int _id;                      // unique in the process
+      QMutex sampleMutex;           // serializes Sample::load() of the synthesizers sharing the font
 
       SFVersion _version;		// sound font version
       SFVersion romver;		      // ROM version
@@ -99,27 +103,29 @@ class SFont {
       void safe_fread(void *buf, int count);
       void safe_fseek(long ofs);
       bool load();
+      bool read(const QString& file, Fluid* synth);
+      void mapSamples();
 
    public:
-      SFont(Fluid* f);
+      SFont();
       virtual ~SFont();
 
+      static QSharedPointer<SFont> shared(const QString& file, Fluid* synth);
+      static void clearCache();
+
       QString get_name()  const                 { return f.fileName(); }
       Preset* get_preset(int bank, int prenum);
 
-      bool read(const QString& file);
-
       int load_sampledata();
       unsigned int samplePos() const            { return samplepos;  }
       int id() const                            { return _id; }
-      void setId(int i)                         { _id = i;    }
       void setSamplepos(unsigned v)             { samplepos = v; }
       void setSamplesize(unsigned v)            { samplesize = v; }
       unsigned getSamplesize() const            { return samplesize; }
+      short* mappedSampleData() const           { return reinterpret_cast<short*>(mappedSamples); }
+      void loadSamples(std::vector<Sample*> samples);
       const QList<Preset*> getPresets() const   { return presets; }
       SFVersion version() const                 { return _version; }
-      int bankOffset() const                    { return _bankOffset; }
-      void setBankOffset(int val)               { _bankOffset = val; }
       QString fontName() const                  { return _fontName; }
 
       friend class Preset;
@@ -131,6 +137,7 @@ class SFont {
 
 class Sample {
       bool _valid;
+      bool _ownsData { true };      // false if data points into the mapped file
 
    public:
       SFont* sf;
@@ -239,7 +246,8 @@ class Preset {
       bool importSfont();
 
       Zone* global_zone()                       { return _global_zone; }
-      void loadSamples();
+      void loadSamples(Fluid* synth);
+      void collectSamples(std::vector<Sample*>* samples) const;
       QList<Zone*> getZones()                   { return zones; }
       };
 
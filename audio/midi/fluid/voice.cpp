@@ -25,6 +25,7 @@
 #include "sfont.h"
 #include "gen.h"
 #include "voice.h"
+#include "audio/midi/simd.h"
 
 namespace FluidS {
 
@@ -862,6 +863,7 @@ void Voice::voice_start()
       positionToTurnOff = -1;
 
       status = FLUID_VOICE_ON;
+      _fluid->voiceChanged(this);
       }
 
 //---------------------------------------------------------
@@ -1156,8 +1158,14 @@ void Voice::update_param(int _gen)
                   * enabled or not.  But here we rely on the default value of -1.
                   */
                   x = GEN(GEN_KEYNUM);
-                  if (x >= 0)
+                  if (x >= 0 && (unsigned char)x != key) {
+                        // a started voice moves to the list of the new key
+                        bool indexed = keyIndexed;
+                        _fluid->unindexVoice(this);
                         key = x;
+                        if (indexed)
+                              _fluid->indexVoice(this);
+                        }
                   break;
 
             case GEN_VELOCITY:
@@ -1499,6 +1507,7 @@ void Voice::noteoff()
             modenv_section = FLUID_VOICE_ENVRELEASE;
             modenv_count = 0;
             }
+      _fluid->voiceChanged(this);
       }
 
 /*
@@ -1539,6 +1548,7 @@ void Voice::kill_excl()
       /* Speed up the modulation envelope */
       gen_set(GEN_MODENVRELEASE, -200);
       update_param(GEN_MODENVRELEASE);
+      _fluid->voiceChanged(this);
       }
 
 //---------------------------------------------------------
@@ -1932,17 +1942,6 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                         b02 += b02_incr;
                         b1  += b1_incr;
                         }
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
                   }
             }
       else { /* The filter parameters are constant.  This is duplicated to save time. */
@@ -1952,19 +1951,12 @@ void Voice::effects(int startBufIdx, int count, float* out, float* reverb, float
                   dspValRef      = b02 * (dsp_centernode + hist2) + b1 * hist1;
                   hist2          = hist1;
                   hist1          = dsp_centernode;
-
-                  //code duplication is needed to optimize using std::vector::operator[]
-                  float vv = dspValRef * amp_left;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
-
-                  vv = dspValRef * amp_right;
-                  *out++ += vv;
-                  *reverb++ += vv * amp_reverb;
-                  *chorus++ += vv * amp_chorus;
                   }
             }
+
+      // the filter is recursive, the panning and effect sends are not
+      if (count > 0)
+            Ms::Simd::mixStereo(dsp_buf.data() + startBufIdx, count, amp_left, amp_right, amp_reverb, amp_chorus, out, reverb, chorus);
       }
 
       /** legato update functions --------------------------------------------------*/
@@ -107,6 +107,14 @@ public:
 	unsigned char key;              // the key, quick access for noteoff
 	unsigned char vel;              // the velocity
 
+      // bookkeeping of Fluid: the list of the key in Channel::keyVoices,
+      // and the entries of the voice stealing heap
+      Voice* prevSameKey = nullptr;
+      Voice* nextSameKey = nullptr;
+      bool keyIndexed = false;
+      unsigned serial = 0;            // allocation order
+      unsigned stealStamp = 0;        // changed with every change of the stealing priority
+
 	Channel* channel;
 	Generator gen[GEN_LAST];
 	Mod mod[FLUID_NUM_MOD];
@@ -68,6 +68,7 @@ set (MIDI_SRC
     ${CMAKE_CURRENT_LIST_DIR}/midipatch.h
     ${CMAKE_CURRENT_LIST_DIR}/msynthesizer.cpp
     ${CMAKE_CURRENT_LIST_DIR}/msynthesizer.h
+    ${CMAKE_CURRENT_LIST_DIR}/simd.h
     ${CMAKE_CURRENT_LIST_DIR}/synthesizer.h
     # ${CMAKE_CURRENT_LIST_DIR}/synthesizergui.cpp
     # ${CMAKE_CURRENT_LIST_DIR}/synthesizergui.h
@@ -13,6 +13,7 @@
 #include "config.h"
 #include "synthesizer.h"
 #include "msynthesizer.h"
+#include "simd.h"
 // #include "synthesizergui.h"
 #include "libmscore/xml.h"
 
@@ -308,9 +309,7 @@ void MasterSynthesizer::process(unsigned n, float* p)
             else
                   _effect[1]->process(n, effect1Buffer, p);
             }
-      float g = _gain * _boost;
-      for (unsigned i = 0; i < n * 2; ++i)
-            *p++ *= g;
+      Simd::scale(p, n * 2, _gain * _boost);
       lock1 = false;
       }
 
@@ -0,0 +1,261 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2021 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include <stddef.h>
+
+//---------------------------------------------------------
+//   vectorized audio kernels
+//    The implementation is selected at compile time:
+//    WebAssembly SIMD128 (-msimd128, see WASM_SIMD),
+//    SSE2 (every x86_64 build, AVX2 builds use it too),
+//    otherwise plain loops.
+//
+//    scale(), mixStereo(), interleave() and deinterleave()
+//    do the same float operations on every target, so
+//    their output is bit-exact.
+//    dot4() and dot7() add the products pairwise
+//    ((p0 + p2) + (p1 + p3)) instead of left to right.
+//    The result differs from the scalar one by at most a
+//    few float roundings of the sum of |c[i] * d[i]|, below
+//    2^-20 of full scale for 16-bit sample data.
+//    All SIMD targets give the same result.
+//---------------------------------------------------------
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define MS_SIMD_WASM
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MS_SIMD_SSE2
+#endif
+
+namespace Ms {
+namespace Simd {
+
+#if defined(MS_SIMD_WASM)
+
+inline v128_t load4s(const short* d)
+      {
+      return wasm_f32x4_convert_i32x4(wasm_i32x4_make(d[0], d[1], d[2], d[3]));
+      }
+
+inline float hsum(v128_t p)
+      {
+      p = wasm_f32x4_add(p, wasm_v32x4_shuffle(p, p, 2, 3, 0, 1));
+      p = wasm_f32x4_add(p, wasm_v32x4_shuffle(p, p, 1, 0, 3, 2));
+      return wasm_f32x4_extract_lane(p, 0);
+      }
+
+#elif defined(MS_SIMD_SSE2)
+
+inline __m128 load4s(const short* d)
+      {
+      __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+      }
+
+inline float hsum(__m128 p)
+      {
+      p = _mm_add_ps(p, _mm_movehl_ps(p, p));
+      p = _mm_add_ss(p, _mm_shuffle_ps(p, p, 1));
+      return _mm_cvtss_f32(p);
+      }
+
+#endif
+
+//---------------------------------------------------------
+//   scale
+//    p[i] *= g, for i in [0, n)
+//---------------------------------------------------------
+
+inline void scale(float* p, size_t n, float g)
+      {
+      size_t i = 0;
+#if defined(MS_SIMD_WASM)
+      const v128_t vg = wasm_f32x4_splat(g);
+      for (; i + 4 <= n; i += 4)
+            wasm_v128_store(p + i, wasm_f32x4_mul(wasm_v128_load(p + i), vg));
+#elif defined(MS_SIMD_SSE2)
+      const __m128 vg = _mm_set1_ps(g);
+      for (; i + 4 <= n; i += 4)
+            _mm_storeu_ps(p + i, _mm_mul_ps(_mm_loadu_ps(p + i), vg));
+#endif
+      for (; i < n; ++i)
+            p[i] *= g;
+      }
+
+//---------------------------------------------------------
+//   deinterleave
+//    src:  [ A0, B0, A1, B1, ... ] (frames * 2)
+//    dest: [ A0, A1, ..., B0, B1, ... ]
+//---------------------------------------------------------
+
+inline void deinterleave(float* dest, const float* src, size_t frames)
+      {
+      size_t i = 0;
+#if defined(MS_SIMD_WASM)
+      for (; i + 4 <= frames; i += 4) {
+            v128_t x = wasm_v128_load(src + 2 * i);
+            v128_t y = wasm_v128_load(src + 2 * i + 4);
+            wasm_v128_store(dest + i, wasm_v32x4_shuffle(x, y, 0, 2, 4, 6));
+            wasm_v128_store(dest + frames + i, wasm_v32x4_shuffle(x, y, 1, 3, 5, 7));
+            }
+#elif defined(MS_SIMD_SSE2)
+      for (; i + 4 <= frames; i += 4) {
+            __m128 x = _mm_loadu_ps(src + 2 * i);
+            __m128 y = _mm_loadu_ps(src + 2 * i + 4);
+            _mm_storeu_ps(dest + i, _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dest + frames + i, _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+#endif
+      for (; i < frames; ++i) {
+            dest[i] = src[2 * i];
+            dest[frames + i] = src[2 * i + 1];
+            }
+      }
+
+//---------------------------------------------------------
+//   interleave
+//    the reverse of deinterleave
+//---------------------------------------------------------
+
+inline void interleave(float* dest, const float* src, size_t frames)
+      {
+      size_t i = 0;
+#if defined(MS_SIMD_WASM)
+      for (; i + 4 <= frames; i += 4) {
+            v128_t a = wasm_v128_load(src + i);
+            v128_t b = wasm_v128_load(src + frames + i);
+            wasm_v128_store(dest + 2 * i, wasm_v32x4_shuffle(a, b, 0, 4, 1, 5));
+            wasm_v128_store(dest + 2 * i + 4, wasm_v32x4_shuffle(a, b, 2, 6, 3, 7));
+            }
+#elif defined(MS_SIMD_SSE2)
+      for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(src + i);
+            __m128 b = _mm_loadu_ps(src + frames + i);
+            _mm_storeu_ps(dest + 2 * i, _mm_unpacklo_ps(a, b));
+            _mm_storeu_ps(dest + 2 * i + 4, _mm_unpackhi_ps(a, b));
+            }
+#endif
+      for (; i < frames; ++i) {
+            dest[2 * i] = src[i];
+            dest[2 * i + 1] = src[frames + i];
+            }
+      }
+
+//---------------------------------------------------------
+//   mixStereo
+//    pan the mono in[0, n) with the left and right gains,
+//    and add it to the interleaved stereo out, and (times
+//    fx1, fx2) to effect1 and effect2
+//---------------------------------------------------------
+
+inline void mixStereo(const float* in, size_t n, float left, float right, float fx1, float fx2,
+   float* out, float* effect1, float* effect2)
+      {
+      size_t i = 0;
+#if defined(MS_SIMD_WASM)
+      const v128_t vl = wasm_f32x4_splat(left);
+      const v128_t vr = wasm_f32x4_splat(right);
+      const v128_t v1 = wasm_f32x4_splat(fx1);
+      const v128_t v2 = wasm_f32x4_splat(fx2);
+      for (; i + 4 <= n; i += 4) {
+            v128_t x = wasm_v128_load(in + i);
+            v128_t l = wasm_f32x4_mul(x, vl);
+            v128_t r = wasm_f32x4_mul(x, vr);
+            v128_t lr[2] = { wasm_v32x4_shuffle(l, r, 0, 4, 1, 5), wasm_v32x4_shuffle(l, r, 2, 6, 3, 7) };
+            for (int k = 0; k < 2; ++k) {
+                  float* o = out + 2 * i + 4 * k;
+                  float* e1 = effect1 + 2 * i + 4 * k;
+                  float* e2 = effect2 + 2 * i + 4 * k;
+                  wasm_v128_store(o, wasm_f32x4_add(wasm_v128_load(o), lr[k]));
+                  wasm_v128_store(e1, wasm_f32x4_add(wasm_v128_load(e1), wasm_f32x4_mul(lr[k], v1)));
+                  wasm_v128_store(e2, wasm_f32x4_add(wasm_v128_load(e2), wasm_f32x4_mul(lr[k], v2)));
+                  }
+            }
+#elif defined(MS_SIMD_SSE2)
+      const __m128 vl = _mm_set1_ps(left);
+      const __m128 vr = _mm_set1_ps(right);
+      const __m128 v1 = _mm_set1_ps(fx1);
+      const __m128 v2 = _mm_set1_ps(fx2);
+      for (; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(in + i);
+            __m128 l = _mm_mul_ps(x, vl);
+            __m128 r = _mm_mul_ps(x, vr);
+            __m128 lr[2] = { _mm_unpacklo_ps(l, r), _mm_unpackhi_ps(l, r) };
+            for (int k = 0; k < 2; ++k) {
+                  float* o = out + 2 * i + 4 * k;
+                  float* e1 = effect1 + 2 * i + 4 * k;
+                  float* e2 = effect2 + 2 * i + 4 * k;
+                  _mm_storeu_ps(o, _mm_add_ps(_mm_loadu_ps(o), lr[k]));
+                  _mm_storeu_ps(e1, _mm_add_ps(_mm_loadu_ps(e1), _mm_mul_ps(lr[k], v1)));
+                  _mm_storeu_ps(e2, _mm_add_ps(_mm_loadu_ps(e2), _mm_mul_ps(lr[k], v2)));
+                  }
+            }
+#endif
+      for (; i < n; ++i) {
+            float l = in[i] * left;
+            float r = in[i] * right;
+            out[2 * i]         += l;
+            out[2 * i + 1]     += r;
+            effect1[2 * i]     += l * fx1;
+            effect1[2 * i + 1] += r * fx1;
+            effect2[2 * i]     += l * fx2;
+            effect2[2 * i + 1] += r * fx2;
+            }
+      }
+
+//---------------------------------------------------------
+//   dot4
+//    c[0] * d[0] + ... + c[3] * d[3]
+//---------------------------------------------------------
+
+inline float dot4(const float* c, const short* d)
+      {
+#if defined(MS_SIMD_WASM)
+      return hsum(wasm_f32x4_mul(wasm_v128_load(c), load4s(d)));
+#elif defined(MS_SIMD_SSE2)
+      return hsum(_mm_mul_ps(_mm_loadu_ps(c), load4s(d)));
+#else
+      return c[0] * d[0] + c[1] * d[1] + c[2] * d[2] + c[3] * d[3];
+#endif
+      }
+
+//---------------------------------------------------------
+//   dot7
+//    c[0] * d[0] + ... + c[6] * d[6]
+//    Reads c[0, 7) and d[0, 7) only: the second half is
+//    [3, 7) with lane 0 (d[3], counted already) zeroed.
+//---------------------------------------------------------
+
+inline float dot7(const float* c, const short* d)
+      {
+#if defined(MS_SIMD_WASM)
+      v128_t hi = wasm_f32x4_replace_lane(load4s(d + 3), 0, 0.0f);
+      return hsum(wasm_f32x4_add(wasm_f32x4_mul(wasm_v128_load(c), load4s(d)),
+         wasm_f32x4_mul(wasm_v128_load(c + 3), hi)));
+#elif defined(MS_SIMD_SSE2)
+      __m128 hi = _mm_move_ss(load4s(d + 3), _mm_setzero_ps());
+      return hsum(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c), load4s(d)),
+         _mm_mul_ps(_mm_loadu_ps(c + 3), hi)));
+#else
+      return c[0] * d[0] + c[1] * d[1] + c[2] * d[2] + c[3] * d[3]
+         + c[4] * d[4] + c[5] * d[5] + c[6] * d[6];
+#endif
+      }
+
+}     // namespace Simd
+}     // namespace Ms
+#endif
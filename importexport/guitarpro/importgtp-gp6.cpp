@@ -218,63 +218,62 @@ const std::map<QString, QString> GuitarPro6::instrumentMapping = {
             };
 
 //---------------------------------------------------------
-//   readBit
+//   GpxBitReader
+//    reads the BCFZ bit stream (most significant bit first),
+//    refilling a 64 bit cache a byte at a time;
+//    bits past the end of the buffer read as 0
 //---------------------------------------------------------
 
-int GuitarPro6::readBit(QByteArray* buffer)
-      {
-      // calculate the byte index by dividing the position in bits by the bits per byte
-      int byteIndex = position / BITS_IN_BYTE;
-
-      // calculate our offset so we know how much to bit shift
-      int byteOffset = ((BITS_IN_BYTE - 1) - (position % BITS_IN_BYTE));
-
-      // calculate the bit which we want to read
-      int bit = ((((*buffer)[byteIndex] & 0xff) >> byteOffset) & 0x01);
-
-      // increment our current position so we know this bit has been read
-      position++;
-      return bit;       // return the bit we calculated
-      }
-
-//---------------------------------------------------------
-//   readBits
-//---------------------------------------------------------
-
-int GuitarPro6::readBits(QByteArray* buffer, int bitsToRead)
-      {
-      int bits = 0;
-      for (int i = (bitsToRead - 1); i >= 0; i--)
-            bits |= (readBit(buffer) << i);
-      return bits;
-      }
-
-//---------------------------------------------------------
-//   readBitsReversed
-//---------------------------------------------------------
-
-int GuitarPro6::readBitsReversed(QByteArray* buffer, int bitsToRead)
-      {
-      int bits = 0;
-      for( int i = 0; i < bitsToRead; i++)
-            bits |= readBit(buffer) << i;
-      return bits;
-      }
+class GpxBitReader {
+      const uchar* _data;
+      int _size;
+      int _pos;               // next byte to load into the cache
+      quint64 _cache { 0 };   // unread bits, left aligned
+      int _count { 0 };       // number of unread bits in the cache
+
+      void refill()
+            {
+            while (_count <= 56) {
+                  quint64 byte = _pos < _size ? _data[_pos] : 0;
+                  _cache |= byte << (56 - _count);
+                  _count += 8;
+                  ++_pos;
+                  }
+            }
 
-//---------------------------------------------------------
-//   getBytes
-//---------------------------------------------------------
+   public:
+      GpxBitReader(const QByteArray& buffer, int offset)
+         : _data(reinterpret_cast<const uchar*>(buffer.constData())), _size(buffer.size()), _pos(offset) {}
+
+      // the bits are read from the most significant bit down (bitsToRead <= 32)
+      int readBits(int bitsToRead)
+            {
+            if (bitsToRead <= 0)
+                  return 0;
+            if (_count < bitsToRead)
+                  refill();
+            int bits = int(_cache >> (64 - bitsToRead));
+            _cache <<= bitsToRead;
+            _count -= bitsToRead;
+            return bits;
+            }
 
-QByteArray GuitarPro6::getBytes(QByteArray* buffer, int offset, int length)
-      {
-      QByteArray newBytes;
-      // compute new bytes from our buffer and return byte array
-      for (int i = 0; i < length; i++) {
-            if (buffer->length() > offset + i)
-                  newBytes.insert(i, ((*buffer)[offset + i]));
+      // the first bit read is the least significant one
+      int readBitsReversed(int bitsToRead)
+            {
+            int bits = readBits(bitsToRead);
+            int reversed = 0;
+            for (int i = 0; i < bitsToRead; i++) {
+                  reversed = (reversed << 1) | (bits & 1);
+                  bits >>= 1;
+                  }
+            return reversed;
             }
-      return newBytes;
-      }
+
+      // every bit of the buffer was read (compared in bits, the
+      // last byte may be partly read)
+      bool atEnd() const { return qint64(_pos) * 8 - _count >= qint64(_size) * 8; }
+      };
 
 //---------------------------------------------------------
 //   readInteger
@@ -288,8 +287,6 @@ int GuitarPro6::readInteger(QByteArray* buffer, int offset)
       bytes[1] = (*buffer)[offset + 1];
       bytes[2] = (*buffer)[offset + 2];
       bytes[3] = (*buffer)[offset + 3];
-      // increment positioning so we keep track of where we are
-      position += sizeof(int) * BITS_IN_BYTE;
       // bit shift in order to compute our integer value and return
       return ((bytes[3] & 0xff) << 24) | ((bytes[2] & 0xff) << 16) | ((bytes[1] & 0xff) << 8) | (bytes[0] & 0xff);
       }
@@ -2588,66 +2585,104 @@ void GuitarPro6::readGPX(QByteArray* buffer)
       int fileHeader = readInteger(buffer, 0);
 
       if (fileHeader == GPX_HEADER_COMPRESSED) {
-            // this is  a compressed file.
-            int length             = readInteger(buffer, position / BITS_IN_BYTE);
-            QByteArray* bcfsBuffer = new QByteArray();
-            int positionCounter    = 0;
-            while(!f->error() && (position / BITS_IN_BYTE) < length) {
+            // this is  a compressed file, the header is followed by the decompressed length
+            int length = readInteger(buffer, sizeof(int));
+
+            // decompress into a preallocated buffer; don't trust huge lengths of corrupt files
+            QByteArray bcfsBuffer;
+            bcfsBuffer.resize(int(qBound(qint64(0), qint64(length), qint64(buffer->length()) * 64)));
+            char* out = bcfsBuffer.data();
+            int n     = 0;
+
+            GpxBitReader reader(*buffer, 2 * sizeof(int));
+            // grow the buffer if the length was wrong
+            auto reserve = [&](int size) {
+                  if (n + size > bcfsBuffer.length()) {
+                        bcfsBuffer.resize(qMax(2 * bcfsBuffer.length(), n + size));
+                        out = bcfsBuffer.data();
+                        }
+                  };
+
+            while (n < length && !reader.atEnd()) {
                   // read the bit indicating compression information
-                  int flag = readBits(buffer, 1);
+                  int flag = reader.readBits(1);
 
                   if (flag) {
-                        int bits = readBits(buffer, 4);
-                        int offs = readBitsReversed(buffer, bits);
-                        int size = readBitsReversed(buffer, bits);
-
-                        QByteArray bcfsBufferCopy = *bcfsBuffer;
-                        int pos                   = (bcfsBufferCopy.length() - offs);
-                        for( int i = 0; i < (size > offs ? offs : size); i++ ) {
-                              bcfsBuffer->insert(positionCounter, bcfsBufferCopy[pos + i] );
-                              positionCounter++;
+                        // a reference to the data decompressed so far
+                        int bits = reader.readBits(4);
+                        int offs = reader.readBitsReversed(bits);
+                        int size = qMin(reader.readBitsReversed(bits), offs);
+                        if (offs > n) {
+                              qDebug("readGPX: invalid offset %d at %d", offs, n);
+                              break;
                               }
+                        reserve(size);
+                        // size <= offs, so the source and the destination don't overlap
+                        memcpy(out + n, out + n - offs, size);
+                        n += size;
                         }
                   else {
-                        int size = readBitsReversed(buffer, 2);
-                        for(int i = 0; i < size; i++) {
-                              bcfsBuffer->insert(positionCounter, readBits(buffer, 8));
-                              positionCounter++;
-                              }
+                        // up to 3 uncompressed bytes
+                        int size = reader.readBitsReversed(2);
+                        reserve(size);
+                        for (int i = 0; i < size; i++)
+                              out[n++] = char(reader.readBits(8));
                         }
                   }
+            bcfsBuffer.resize(n);
             // recurse on the decompressed file stored as a byte array
-            readGPX(bcfsBuffer);
-            delete bcfsBuffer;
+            readGPX(&bcfsBuffer);
             }
       else if (fileHeader == GPX_HEADER_UNCOMPRESSED) {
-            // this is an uncompressed file - strip the header off
-            *buffer = buffer->right(buffer->length() - sizeof(int));
-            int sectorSize = 0x1000;
-            int offset     = 0;
-            while ((offset = (offset + sectorSize)) + 3 < buffer->length()) {
-                  int newInt = readInteger(buffer,offset);
+            // this is an uncompressed file - skip the header, without copying
+            QByteArray sectors = QByteArray::fromRawData(buffer->constData() + sizeof(int), buffer->length() - sizeof(int));
+            const int sectorSize = 0x1000;
+            int offset           = 0;
+            while ((offset = (offset + sectorSize)) + 3 < sectors.length()) {
+                  int newInt = readInteger(&sectors, offset);
                   if (newInt == 2) {
                         int indexFileName = (offset + 4);
                         int indexFileSize = (offset + 0x8C);
                         int indexOfBlock  = (offset + 0x94);
 
-                        // create a byte array and put information about files found in it
-                        int block             = 0;
-                        int blockCount        = 0;
-                        QByteArray* fileBytes = new QByteArray();
-                        while((block = (readInteger(buffer, (indexOfBlock + (4 * (blockCount++)))))) != 0 ) {
-                              fileBytes->push_back(getBytes(buffer, (offset = (block * sectorSize)), sectorSize));
+                        // collect the sectors of the file
+                        int fileSize    = readInteger(&sectors, indexFileSize);
+                        int block       = 0;
+                        int blockCount  = 0;
+                        int firstOffset = -1;
+                        bool contiguous = true;
+                        QVector<int> blocks;
+                        while ((block = (readInteger(&sectors, (indexOfBlock + (4 * (blockCount++)))))) != 0) {
+                              offset = block * sectorSize;
+                              if (firstOffset < 0)
+                                    firstOffset = offset;
+                              else if (offset != firstOffset + blocks.size() * sectorSize)
+                                    contiguous = false;
+                              blocks.append(offset);
                               }
-                        // get file information and read the file
-                        int fileSize = readInteger(buffer, indexFileSize);
-                        if (fileBytes->length() >= fileSize) {
-                              QByteArray filenameBytes = readString(buffer, indexFileName, 127);
-                              char* filename           = filenameBytes.data();
-                              QByteArray data          = getBytes(fileBytes, 0, fileSize);
+
+                        // the file data available in the sectors
+                        int available = 0;
+                        for (int blockOffset : blocks)
+                              available += qBound(0, sectors.length() - blockOffset, sectorSize);
+                        if (blocks.isEmpty() || available < fileSize)
+                              continue;
+
+                        QByteArray filenameBytes = readString(&sectors, indexFileName, 127);
+                        char* filename           = filenameBytes.data();
+                        if (contiguous) {
+                              // usually the sectors are in order, and the file is read in place
+                              QByteArray data = QByteArray::fromRawData(sectors.constData() + firstOffset, fileSize);
+                              parseFile(filename, &data);
+                              }
+                        else {
+                              QByteArray data;
+                              data.reserve(available);
+                              for (int blockOffset : blocks)
+                                    data.append(sectors.constData() + blockOffset, qBound(0, sectors.length() - blockOffset, sectorSize));
+                              data.truncate(fileSize);
                               parseFile(filename, &data);
                               }
-                        delete fileBytes;
                         }
                   }
             }
@@ -2667,7 +2702,7 @@ int GuitarPro6::readBeatEffects(int, Segment*)
 //   read
 //---------------------------------------------------------
 
-bool GuitarPro6::read(QFile* fp)
+bool GuitarPro6::read(QIODevice* fp)
       {
       f = fp;
       previousTempo = -1;
@@ -107,7 +107,7 @@ void GuitarPro7::readTracks(QDomNode* track)
 //   read
 //---------------------------------------------------------
 
-bool GuitarPro7::read(QFile* fp)
+bool GuitarPro7::read(QIODevice* fp)
       {
       f = fp;
       previousTempo = -1;
@@ -1046,7 +1046,7 @@ void GuitarPro::applyBeatEffects(Chord* chord, int beatEffect)
 //   read
 //---------------------------------------------------------
 
-bool GuitarPro1::read(QFile* fp)
+bool GuitarPro1::read(QIODevice* fp)
       {
       f      = fp;
       curPos = 30;
@@ -1423,7 +1423,7 @@ void GuitarPro::createOttava(bool hasOttava, int track, ChordRest* cr, QString v
 //   read
 //---------------------------------------------------------
 
-bool GuitarPro2::read(QFile* fp)
+bool GuitarPro2::read(QIODevice* fp)
       {
       f      = fp;
       curPos = 30;
@@ -2076,7 +2076,7 @@ int GuitarPro1::readBeatEffects(int, Segment*)
 //   read
 //---------------------------------------------------------
 
-bool GuitarPro3::read(QFile* fp)
+bool GuitarPro3::read(QIODevice* fp)
       {
       f      = fp;
       curPos = 30;
@@ -2714,13 +2714,27 @@ Score::FileError importGTP(MasterScore* score, const QString& name)
             return Score::FileError::FILE_NOT_FOUND;
       if (!fp.open(QIODevice::ReadOnly))
             return Score::FileError::FILE_OPEN_ERROR;
+      return importGTP(score, &fp, name);
+      }
+
+//---------------------------------------------------------
+//   importGTP
+//    read from an already available device, e.g. a QBuffer
+//    over in-memory data; \a name is only used to detect
+//    the file type by its extension
+//---------------------------------------------------------
+
+Score::FileError importGTP(MasterScore* score, QIODevice* io, const QString& name)
+      {
+      if (!io->isOpen() && !io->open(QIODevice::ReadOnly))
+            return Score::FileError::FILE_OPEN_ERROR;
 
       char header[5];
-      fp.read(header, 4);
+      io->read(header, 4);
       header[4] = 0;
-      fp.seek(0);
+      io->seek(0);
       if (name.endsWith(".ptb", Qt::CaseInsensitive) || strcmp(header, "ptab") == 0) {
-            PowerTab ptb(&fp, score);
+            PowerTab ptb(io, score);
             return ptb.read();
             }
 
@@ -2730,22 +2744,22 @@ Score::FileError importGTP(MasterScore* score, const QString& name)
       if (name.endsWith(".gp", Qt::CaseInsensitive)) {
             gp = new GuitarPro7(score);
             gp->initGuitarProDrumset();
-            readResult = gp->read(&fp);
+            readResult = gp->read(io);
             gp->setTempo(0, 0);
             }
       // check to see if we are dealing with a GPX file via the extension
       else if (name.endsWith(".gpx", Qt::CaseInsensitive) || strcmp(header, "BCFZ") == 0) {
             gp = new GuitarPro6(score);
             gp->initGuitarProDrumset();
-            readResult = gp->read(&fp);
+            readResult = gp->read(io);
             gp->setTempo(0, 0);
             }
       // otherwise it's an older version - check the header
       else  if (strcmp(&header[1], "FIC") == 0) {
             uchar l;
-            fp.read((char*)&l, 1);
+            io->read((char*)&l, 1);
             char ss[30];
-            fp.read(ss, 30);
+            io->read(ss, 30);
             ss[l] = 0;
             QString s(ss);
             if (s.startsWith("FICHIER GUITAR PRO "))
@@ -2774,7 +2788,7 @@ Score::FileError importGTP(MasterScore* score, const QString& name)
                   return Score::FileError::FILE_BAD_FORMAT;
                   }
             gp->initGuitarProDrumset();
-            readResult = gp->read(&fp);
+            readResult = gp->read(io);
             gp->setTempo(0, 0);
             }
       else {
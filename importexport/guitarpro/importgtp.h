@@ -58,6 +58,7 @@ static const int GP_VOLTA_BINARY = 1;
 static const int GP_VOLTA_FLAGS = 2;
 
 Score::FileError importGTP(Score* score, const QString& filename, const char* data, unsigned int data_len);
+Score::FileError importGTP(MasterScore* score, QIODevice* io, const QString& name);
 
 enum class Repeat : char;
 
@@ -198,7 +199,7 @@ class GuitarPro {
       std::vector<Ottava*> ottava;
       Hairpin** hairpins;
       MasterScore* score;
-      QFile* f;
+      QIODevice* f;
       int curPos;
       int previousTempo;
       int previousDynamic;
@@ -274,7 +275,7 @@ class GuitarPro {
 
       GuitarPro(MasterScore*, int v);
       virtual ~GuitarPro();
-      virtual bool read(QFile*) = 0;
+      virtual bool read(QIODevice*) = 0;
       QString error(GuitarProError n) const { return QString(errmsg[int(n)]); }
       };
 
@@ -290,7 +291,7 @@ class GuitarPro1 : public GuitarPro {
 
    public:
       GuitarPro1(MasterScore* s, int v) : GuitarPro(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 //---------------------------------------------------------
@@ -301,7 +302,7 @@ class GuitarPro2 : public GuitarPro1 {
 
    public:
       GuitarPro2(MasterScore* s, int v) : GuitarPro1(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 //---------------------------------------------------------
@@ -313,7 +314,7 @@ class GuitarPro3 : public GuitarPro1 {
 
    public:
       GuitarPro3(MasterScore* s, int v) : GuitarPro1(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 //---------------------------------------------------------
@@ -331,7 +332,7 @@ class GuitarPro4 : public GuitarPro {
 
    public:
       GuitarPro4(MasterScore* s, int v) : GuitarPro(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 //---------------------------------------------------------
@@ -355,7 +356,7 @@ class GuitarPro5 : public GuitarPro {
 
    public:
       GuitarPro5(MasterScore* s, int v) : GuitarPro(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 //---------------------------------------------------------
@@ -370,9 +371,6 @@ class GuitarPro6 : public GuitarPro {
       const int GPX_HEADER_UNCOMPRESSED = 1397113666;
       // an integer stored in the header indicating that the file is not compressed (BCFZ).
       const int GPX_HEADER_COMPRESSED = 1514554178;
-      int position = 0;
-      // a constant storing the amount of bits per byte
-      const int BITS_IN_BYTE = 8;
       // contains all the information about notes that will go in the parts
       struct GPPartInfo {
             QDomNode masterBars;
@@ -386,13 +384,9 @@ class GuitarPro6 : public GuitarPro {
       // a mapping from identifiers to fret diagrams
       QMap<int, FretDiagram*> fretDiagrams;
       void parseFile(const char* filename, QByteArray* data);
-      int readBit(QByteArray* buffer);
-      QByteArray getBytes(QByteArray* buffer, int offset, int length);
       void readGPX(QByteArray* buffer);
       int readInteger(QByteArray* buffer, int offset);
       QByteArray readString(QByteArray* buffer, int offset, int length);
-      int readBits(QByteArray* buffer, int bitsToRead);
-      int readBitsReversed(QByteArray* buffer, int bitsToRead);
       void readScore(QDomNode* metadata);
       void readChord(QDomNode* diagram, int track);
       int findNumMeasures(GPPartInfo* partInfo);
@@ -422,7 +416,7 @@ class GuitarPro6 : public GuitarPro {
    public:
       GuitarPro6(MasterScore* s) : GuitarPro(s, 6) {}
       GuitarPro6(MasterScore* s, int v) : GuitarPro(s, v) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 class GuitarPro7 : public GuitarPro6 {
@@ -430,7 +424,7 @@ class GuitarPro7 : public GuitarPro6 {
 
    public:
       GuitarPro7(MasterScore* s) : GuitarPro6(s, 7) {}
-      virtual bool read(QFile*);
+      virtual bool read(QIODevice*);
       };
 
 } // namespace Ms
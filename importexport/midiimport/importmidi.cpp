@@ -1173,6 +1173,31 @@ void loadMidiData(MidiFile &mf)
       mf.setMidiType(mt);
       }
 
+//---------------------------------------------------------
+//   readMidiFile
+//---------------------------------------------------------
+
+static Score::FileError readMidiFile(MidiFile &mf, QIODevice *dev)
+      {
+      try {
+            mf.read(dev);
+            }
+      catch (QString errorText) {
+#if 0
+            if (!MScore::noGui) {
+                  QMessageBox::warning(0,
+                     QWidget::tr("Load MIDI"),
+                     QWidget::tr("Load failed: %1").arg(errorText),
+                     QString(), QWidget::tr("Quit"), QString(), 0, 1);
+                  }
+#endif
+            qDebug("importMidi: bad file format");
+            return Score::FileError::FILE_BAD_FORMAT;
+            }
+      loadMidiData(mf);
+      return Score::FileError::FILE_NO_ERROR;
+      }
+
 Score::FileError importMidi(MasterScore *score, const QString &name)
       {
       if (name.isEmpty())
@@ -1192,25 +1217,11 @@ Score::FileError importMidi(MasterScore *score, const QString &name)
                   return Score::FileError::FILE_OPEN_ERROR;
                   }
             MidiFile mf;
-            try {
-                  mf.read(&fp);
-                  }
-            catch (QString errorText) {
-#if 0
-                  if (!MScore::noGui) {
-                        QMessageBox::warning(0,
-                           QWidget::tr("Load MIDI"),
-                           QWidget::tr("Load failed: %1").arg(errorText),
-                           QString(), QWidget::tr("Quit"), QString(), 0, 1);
-                        }
-#endif
-                  fp.close();
-                  qDebug("importMidi: bad file format");
-                  return Score::FileError::FILE_BAD_FORMAT;
-                  }
+            const Score::FileError rv = readMidiFile(mf, &fp);
             fp.close();
+            if (rv != Score::FileError::FILE_NO_ERROR)
+                  return rv;
 
-            loadMidiData(mf);
             opers.setMidiFileData(name, mf);
             }
 
@@ -1219,5 +1230,43 @@ Score::FileError importMidi(MasterScore *score, const QString &name)
 
       return Score::FileError::FILE_NO_ERROR;
       }
+
+//---------------------------------------------------------
+//   importMidi
+//    read from an already available device, e.g. a QBuffer
+//    over in-memory data.
+//    The device can not be read again for a reimport with
+//    other operations, so the file data is not kept in
+//    midiImportOperations once the score is converted.
+//---------------------------------------------------------
+
+Score::FileError importMidi(MasterScore *score, QIODevice *dev, const QString &name)
+      {
+      if (name.isEmpty())
+            return Score::FileError::FILE_NOT_FOUND;
+      if (!dev->isOpen() && !dev->open(QIODevice::ReadOnly)) {
+            qDebug("importMidi: device open error <%s>", qPrintable(name));
+            return Score::FileError::FILE_OPEN_ERROR;
+            }
+
+      auto &opers = midiImportOperations;
+      opers.excludeMidiFile(name);  // never reuse data from another device of the same name
+
+      Score::FileError rv;
+      {
+      MidiOperations::CurrentMidiFileSetter setCurrentMidiFile(opers, name);
+      opers.addNewMidiFile(name);
+
+      MidiFile mf;
+      rv = readMidiFile(mf, dev);
+      if (rv == Score::FileError::FILE_NO_ERROR) {
+            opers.setMidiFileData(name, mf);
+            opers.data()->tracks = convertMidi(score, opers.midiFile(name));
+            }
+      }
+
+      opers.excludeMidiFile(name);
+      return rv;
+      }
 }
 
@@ -128,12 +128,12 @@ static int musicXMLValidationErrorDialog(QString text, QString detailedText)
 //---------------------------------------------------------
 
 /**
-Extract rootfile from compressed MusicXML file \a qf, return true if OK and false on error.
+Extract rootfile from compressed MusicXML data \a dev named \a name, return true if OK and false on error.
 */
 
-static bool extractRootfile(QFile* qf, QByteArray& data)
+static bool extractRootfile(QIODevice* dev, const QString& name, QByteArray& data)
       {
-      MQZipReader f(qf->fileName());
+      MQZipReader f(dev);
       data = f.fileData("META-INF/container.xml");
 
       QDomDocument container;
@@ -168,8 +168,8 @@ static bool extractRootfile(QFile* qf, QByteArray& data)
             }
 
       if (rootfile == "") {
-            qDebug("can't find rootfile in: %s", qPrintable(qf->fileName()));
-            MScore::lastError = QObject::tr("Can't find rootfile\n%1").arg(qf->fileName());
+            qDebug("can't find rootfile in: %s", qPrintable(name));
+            MScore::lastError = QObject::tr("Can't find rootfile\n%1").arg(name);
             return false;
             }
 
@@ -260,7 +260,7 @@ Score::FileError importMusicXml(MasterScore* score, QIODevice* dev, const QStrin
       {
       ScoreLoad sl;     // suppress warnings for undo push/pop
 
-      if (!dev->open(QIODevice::ReadOnly)) {
+      if (!dev->isOpen() && !dev->open(QIODevice::ReadOnly)) {
             qDebug("importMusicXml() could not open MusicXML file '%s'", qPrintable(name));
             MScore::lastError = QObject::tr("Could not open MusicXML file\n%1").arg(name);
             return Score::FileError::FILE_OPEN_ERROR;
@@ -295,6 +295,29 @@ Score::FileError importMusicXml(MasterScore* score, const QString& name) {
 //    return false on error
 //---------------------------------------------------------
 
+/**
+ Import compressed MusicXML data \a name contained in QIODevice \a dev into the Score.
+ */
+
+Score::FileError importCompressedMusicXml(MasterScore* score, QIODevice* dev, const QString& name)
+      {
+      if (!dev->isOpen() && !dev->open(QIODevice::ReadOnly)) {
+            qDebug("importCompressedMusicXml() could not open compressed MusicXML file '%s'", qPrintable(name));
+            MScore::lastError = QObject::tr("Could not open compressed MusicXML file\n%1").arg(name);
+            return Score::FileError::FILE_OPEN_ERROR;
+            }
+
+      // extract the root file
+      QByteArray data;
+      if (!extractRootfile(dev, name, data))
+            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by extractRootfile
+      QBuffer buffer(&data);
+      buffer.open(QIODevice::ReadOnly);
+
+      // and import it
+      return doValidateAndImport(score, name, &buffer);
+      }
+
 /**
  Import compressed MusicXML file \a name into the Score.
  */
@@ -313,15 +336,7 @@ Score::FileError importCompressedMusicXml(MasterScore* score, const QString& nam
             return Score::FileError::FILE_OPEN_ERROR;
             }
 
-      // extract the root file
-      QByteArray data;
-      if (!extractRootfile(&mxlFile, data))
-            return Score::FileError::FILE_BAD_FORMAT;  // appropriate error message has been printed by extractRootfile
-      QBuffer buffer(&data);
-      buffer.open(QIODevice::ReadOnly);
-
-      // and import it
-      return doValidateAndImport(score, name, &buffer);
+      return importCompressedMusicXml(score, &mxlFile, name);
       }
 
 //---------------------------------------------------------
@@ -53,6 +53,7 @@ Bend::Bend(Score* s)
 
 QFont Bend::font(qreal sp) const
       {
+      MScore::loadFont(_fontFace);
       QFont f(_fontFace);
       f.setBold(_fontStyle & FontStyle::Bold);
       f.setItalic(_fontStyle & FontStyle::Italic);
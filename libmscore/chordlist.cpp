@@ -1814,12 +1814,12 @@ bool ChordList::read(const QString& name)
       if (ftest.isAbsolute())
             path = name;
       else {
-            path = QString("/styles/%1").arg(name);
+            path = QString(MS_DATA_PATH("/styles/%1")).arg(name);
       }
       // default to chords_std.xml
       QFileInfo fi(path);
       if (!fi.exists())
-            path = QString("/styles/chords_std.xml");
+            path = QString(MS_DATA_PATH("/styles/chords_std.xml"));
 
       if (name.isEmpty())
             return false;
@@ -1280,4 +1280,16 @@ void Excerpt::setPartScore(Score* s)
       s->setExcerpt(this);
       }
 
+//---------------------------------------------------------
+//   deletePartScore
+//    free the part score, the excerpt keeps its parts and
+//    tracks, so createExcerpt() can build it again
+//---------------------------------------------------------
+
+void Excerpt::deletePartScore()
+      {
+      delete _partScore;
+      _partScore = nullptr;
+      }
+
 }
@@ -57,6 +57,7 @@ class Excerpt : public QObject {
       MasterScore* oscore() const          { return _oscore;    }
       Score* partScore() const             { return _partScore; }
       void setPartScore(Score* s);
+      void deletePartScore();
 
       void read(XmlReader&);
 
@@ -468,6 +468,7 @@ void FiguredBassItem::layout()
 
       // construct font metrics
       int   fontIdx = 0;
+      MScore::loadFont(g_FBFonts.at(fontIdx).family);
       QFont f(g_FBFonts.at(fontIdx).family);
 
       // font size in pixels, scaled according to spatium()
@@ -575,6 +576,7 @@ void FiguredBassItem::draw(QPainter* painter) const
       int   font = 0;
       qreal _spatium = spatium();
       // set font from general style
+      MScore::loadFont(g_FBFonts.at(font).family);
       QFont f(g_FBFonts.at(font).family);
 #ifdef USE_GLYPHS
       f.setHintingPreference(QFont::PreferVerticalHinting);
@@ -1639,7 +1641,7 @@ bool FiguredBass::readConfigFile(const QString& fileName)
             path = rpath + QString("/fonts_figuredbass.xml");
             }
 #else
-            path = "/fonts/fonts_figuredbass.xml";
+            path = MS_DATA_PATH("/fonts/fonts_figuredbass.xml");
 #endif
             g_FBFonts.clear();
             }
@@ -50,6 +50,7 @@ static const ElementStyle fretStyle {
 FretDiagram::FretDiagram(Score* score)
    : Element(score, ElementFlag::MOVABLE | ElementFlag::ON_STAFF)
       {
+      MScore::loadFont("FreeSans");
       font.setFamily("FreeSans");
       font.setPointSize(4.0 * mag());
       initElementStyle(&fretStyle);
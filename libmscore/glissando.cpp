@@ -106,13 +106,17 @@ void GlissandoSegment::draw(QPainter* painter) const
             for (int i = 0; i < n; ++i)
                   ids.push_back(SymId::wiggleTrill);
             // this is very ugly but fix #68846 for now
-            bool tmp = MScore::pdfPrinting;
-            MScore::pdfPrinting = true;
+            // (not written when already set, pages may be printed in parallel)
+            const bool printing = MScore::pdfPrinting;
+            if (!printing)
+                  MScore::pdfPrinting = true;
             score()->scoreFont()->draw(ids, painter, magS(), QPointF(x, -(b.y() + b.height()*0.5) ), scale);
-            MScore::pdfPrinting = tmp;
+            if (!printing)
+                  MScore::pdfPrinting = false;
             }
 
       if (glissando()->showText()) {
+            MScore::loadFont(glissando()->fontFace());
             QFont f(glissando()->fontFace());
             f.setPointSizeF(glissando()->fontSize() * MScore::pixelRatio * _spatium / SPATIUM20);
             f.setBold(glissando()->fontStyle() & FontStyle::Bold);
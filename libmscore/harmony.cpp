@@ -1728,8 +1728,10 @@ void Harmony::render()
       for (const ChordFont& cf : qAsConst(chordList->fonts)) {
             QFont ff(font());
             ff.setPointSizeF(ff.pointSizeF() * cf.mag);
-            if (!(cf.family.isEmpty() || cf.family == "default"))
+            if (!(cf.family.isEmpty() || cf.family == "default")) {
+                  MScore::loadFont(cf.family);
                   ff.setFamily(cf.family);
+                  }
             fontList.append(ff);
             }
       if (fontList.empty())
@@ -17,15 +17,22 @@ namespace Ms {
 
     bool saveSvg(Score*, QIODevice*, int pageNum = 0, bool drawPageBackground = false, const NotesColors& notesColors = NotesColors());
     bool savePng(Score*, QIODevice*, int pageNum = 0, bool drawPageBackground = false, bool transparent = true);
+    // every page, laid out once
+    QList<QByteArray> saveSvgAll(Score*, bool drawPageBackground = false, const NotesColors& notesColors = NotesColors());
+    QList<QByteArray> savePngAll(Score*, bool drawPageBackground = false, bool transparent = true);
 
     bool savePdf(Score* score, QIODevice* device);
+    // one PDF per score, printed in parallel
+    QList<QByteArray> savePdfAll(const QList<Score*>& scores);
 
     bool saveMidi(Score* score, QIODevice* device, bool midiExpandRepeats, bool exportRPNs);
 
     bool saveAudio(Score* score, QIODevice *device, std::function<bool(float, float)> updateProgress, float starttime = 0, bool audioNormalize = true);
     bool saveAudio(Score* score, const QString& filename);
+    bool encodeAudio(Score* score, const QString& format, QByteArray* data, bool normalize = true);
 
     std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime = 0);
+    std::function<SynthRes*(bool)> encodeAudioWorklet(Score* score, const QString& format);
 
     QJsonObject savePositions(Score* score, bool segments);
 
@@ -43,6 +50,12 @@ namespace Ms {
     extern Score::FileError importBB(MasterScore*, const QString& name);
     extern Score::FileError importCapella(MasterScore*, const QString& name);
     extern Score::FileError importCapXml(MasterScore*, const QString& name);
+
+    // imports from in-memory data (e.g. a QBuffer), `name` is only used for file type detection and error messages
+    extern Score::FileError importMidi(MasterScore*, QIODevice*, const QString& name);
+    extern Score::FileError importGTP(MasterScore*, QIODevice*, const QString& name);
+    extern Score::FileError importMusicXml(MasterScore*, QIODevice*, const QString& name);
+    extern Score::FileError importCompressedMusicXml(MasterScore*, QIODevice*, const QString& name);
 }
 
 #endif
@@ -923,7 +923,7 @@ void Measure::add(Element* e)
                   break;
 
             case ElementType::MEASURE:
-                  _mmRest = toMeasure(e);
+                  setMMRest(toMeasure(e));
                   break;
 
             case ElementType::STAFFTYPE_CHANGE:
@@ -1035,7 +1035,7 @@ void Measure::remove(Element* e)
                   break;
 
             case ElementType::MEASURE:
-                  _mmRest = 0;
+                  setMMRest(0);
                   break;
 
             case ElementType::STAFFTYPE_CHANGE:
@@ -2149,17 +2149,9 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
 
       while (e.readNextStartElement()) {
             const QStringRef& tag(e.name());
+            const ElementType type = ScoreElement::name2type(tag, true);
 
-            if (tag == "location") {
-                  Location loc = Location::relative();
-                  loc.read(e);
-                  e.setLocation(loc);
-                  }
-            else if (tag == "tick") {           // obsolete?
-                  qDebug("read midi tick");
-                  e.setTick(Fraction::fromTicks(score()->fileDivision(e.readInt())));
-                  }
-            else if (tag == "BarLine") {
+            if (type == ElementType::BAR_LINE) {
                   BarLine* barLine = new BarLine(score());
                   barLine->setTrack(e.track());
                   barLine->read(e);
@@ -2194,7 +2186,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                         fermata = nullptr;
                         }
                   }
-            else if (tag == "Chord") {
+            else if (type == ElementType::CHORD) {
                   Chord* chord = new Chord(score());
                   chord->setTrack(e.track());
                   chord->read(e);
@@ -2224,7 +2216,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                         fermata = nullptr;
                         }
                   }
-            else if (tag == "Rest") {
+            else if (type == ElementType::REST) {
                   Rest* rest = new Rest(score());
                   rest->setDurationType(TDuration::DurationType::V_MEASURE);
                   rest->setTicks(timesig()/timeStretch);
@@ -2248,7 +2240,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                         tuplet->add(rest);
                   e.incTick(rest->actualTicks());
                   }
-            else if (tag == "Breath") {
+            else if (type == ElementType::BREATH) {
                   Breath* breath = new Breath(score());
                   breath->setTrack(e.track());
                   breath->setPlacement(breath->track() & 1 ? Placement::BELOW : Placement::ABOVE);
@@ -2256,9 +2248,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   segment = getSegment(SegmentType::Breath, e.tick());
                   segment->add(breath);
                   }
-            else if (tag == "Spanner")
-                  Spanner::readSpanner(e, this, e.track());
-            else if (tag == "RepeatMeasure") {
+            else if (type == ElementType::REPEAT_MEASURE) {
                   RepeatMeasure* rm = new RepeatMeasure(score());
                   rm->setTrack(e.track());
                   rm->read(e);
@@ -2266,7 +2256,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   segment->add(rm);
                   e.incTick(ticks());
                   }
-            else if (tag == "Clef") {
+            else if (type == ElementType::CLEF) {
                   Clef* clef = new Clef(score());
                   clef->setTrack(e.track());
                   clef->read(e);
@@ -2294,7 +2284,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   segment = getSegment(header ? SegmentType::HeaderClef : SegmentType::Clef, e.tick());
                   segment->add(clef);
                   }
-            else if (tag == "TimeSig") {
+            else if (type == ElementType::TIMESIG) {
                   TimeSig* ts = new TimeSig(score());
                   ts->setTrack(e.track());
                   ts->read(e);
@@ -2324,7 +2314,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                               }
                         }
                   }
-            else if (tag == "KeySig") {
+            else if (type == ElementType::KEYSIG) {
                   KeySig* ks = new KeySig(score());
                   ks->setTrack(e.track());
                   ks->read(e);
@@ -2342,7 +2332,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                               staff->setKey(curTick, ks->keySigEvent());
                         }
                   }
-            else if (tag == "Text") {
+            else if (type == ElementType::TEXT) {
                   StaffText* t = new StaffText(score());
                   t->setTrack(e.track());
                   t->read(e);
@@ -2359,27 +2349,27 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
             //----------------------------------------------------
             // Annotation
 
-            else if (tag == "Dynamic") {
+            else if (type == ElementType::DYNAMIC) {
                   Dynamic* dyn = new Dynamic(score());
                   dyn->setTrack(e.track());
                   dyn->read(e);
                   segment = getSegment(SegmentType::ChordRest, e.tick());
                   segment->add(dyn);
                   }
-            else if (tag == "Harmony"
-               || tag == "FretDiagram"
-               || tag == "TremoloBar"
-               || tag == "Symbol"
-               || tag == "Tempo"
-               || tag == "StaffText"
-               || tag == "Sticking"
-               || tag == "SystemText"
-               || tag == "RehearsalMark"
-               || tag == "InstrumentChange"
-               || tag == "StaffState"
-               || tag == "FiguredBass"
+            else if (type == ElementType::HARMONY
+               || type == ElementType::FRET_DIAGRAM
+               || type == ElementType::TREMOLOBAR
+               || type == ElementType::SYMBOL
+               || type == ElementType::TEMPO_TEXT
+               || type == ElementType::STAFF_TEXT
+               || type == ElementType::STICKING
+               || type == ElementType::SYSTEM_TEXT
+               || type == ElementType::REHEARSAL_MARK
+               || type == ElementType::INSTRUMENT_CHANGE
+               || type == ElementType::STAFF_STATE
+               || type == ElementType::FIGURED_BASS
                ) {
-                  Element* el = Element::name2Element(tag, score());
+                  Element* el = Element::create(type, score());
                   // hack - needed because tick tags are unreliable in 1.3 scores
                   // for symbols attached to anything but a measure
                   el->setTrack(e.track());
@@ -2387,17 +2377,17 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   segment = getSegment(SegmentType::ChordRest, e.tick());
                   segment->add(el);
                   }
-            else if (tag == "Fermata") {
+            else if (type == ElementType::FERMATA) {
                   fermata = new Fermata(score());
                   fermata->setTrack(e.track());
                   fermata->setPlacement(fermata->track() & 1 ? Placement::BELOW : Placement::ABOVE);
                   fermata->read(e);
                   }
-            else if (tag == "Image") {
+            else if (type == ElementType::IMAGE) {
                   if (MScore::noImages)
                         e.skipCurrentElement();
                   else {
-                        Element* el = Element::name2Element(tag, score());
+                        Element* el = Element::create(type, score());
                         el->setTrack(e.track());
                         el->read(e);
                         segment = getSegment(SegmentType::ChordRest, e.tick());
@@ -2405,7 +2395,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                         }
                   }
             //----------------------------------------------------
-            else if (tag == "Tuplet") {
+            else if (type == ElementType::TUPLET) {
                   Tuplet* oldTuplet = tuplet;
                   tuplet = new Tuplet(score());
                   tuplet->setTrack(e.track());
@@ -2415,24 +2405,7 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   if (oldTuplet)
                         oldTuplet->add(tuplet);
                   }
-            else if (tag == "endTuplet") {
-                  if (!tuplet) {
-                        qDebug("Measure::read: encountered <endTuplet/> when no tuplet was started");
-                        e.skipCurrentElement();
-                        continue;
-                        }
-                  Tuplet* oldTuplet = tuplet;
-                  tuplet = tuplet->tuplet();
-                  if (oldTuplet->elements().empty()) {
-                        // this should not happen and is a sign of input file corruption
-                        qDebug("Measure:read: empty tuplet in measure index=%d, input file corrupted?", e.currentMeasureIndex());
-                        if (tuplet)
-                              tuplet->remove(oldTuplet);
-                        delete oldTuplet;
-                        }
-                  e.readNext();
-                  }
-            else if (tag == "Beam") {
+            else if (type == ElementType::BEAM) {
                   Beam* beam = new Beam(score());
                   beam->setTrack(e.track());
                   beam->read(e);
@@ -2443,9 +2416,9 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                         }
                   startingBeam = beam;
                   }
-            else if (tag == "Segment" && segment)
+            else if (type == ElementType::SEGMENT && segment)
                   segment->read(e);
-            else if (tag == "Ambitus") {
+            else if (type == ElementType::AMBITUS) {
                   Ambitus* range = new Ambitus(score());
                   range->read(e);
                   segment = getSegment(SegmentType::Ambitus, e.tick());
@@ -2453,6 +2426,34 @@ void Measure::readVoice(XmlReader& e, int staffIdx, bool irregular)
                   range->setTrack(trackZeroVoice(e.track()));
                   segment->add(range);
                   }
+            else if (tag == "Spanner")
+                  Spanner::readSpanner(e, this, e.track());
+            else if (tag == "location") {
+                  Location loc = Location::relative();
+                  loc.read(e);
+                  e.setLocation(loc);
+                  }
+            else if (tag == "tick") {           // obsolete?
+                  qDebug("read midi tick");
+                  e.setTick(Fraction::fromTicks(score()->fileDivision(e.readInt())));
+                  }
+            else if (tag == "endTuplet") {
+                  if (!tuplet) {
+                        qDebug("Measure::read: encountered <endTuplet/> when no tuplet was started");
+                        e.skipCurrentElement();
+                        continue;
+                        }
+                  Tuplet* oldTuplet = tuplet;
+                  tuplet = tuplet->tuplet();
+                  if (oldTuplet->elements().empty()) {
+                        // this should not happen and is a sign of input file corruption
+                        qDebug("Measure:read: empty tuplet in measure index=%d, input file corrupted?", e.currentMeasureIndex());
+                        if (tuplet)
+                              tuplet->remove(oldTuplet);
+                        delete oldTuplet;
+                        }
+                  e.readNext();
+                  }
             else
                   e.unknown();
             }
@@ -3317,6 +3318,18 @@ QVariant Measure::propertyDefault(Pid propertyId) const
       return MeasureBase::propertyDefault(propertyId);
       }
 
+//---------------------------------------------------------
+//   setMMRest
+//---------------------------------------------------------
+
+void Measure::setMMRest(Measure* m)
+      {
+      if (_mmRest == m)
+            return;
+      _mmRest = m;
+      score()->setMeasureTickIndexDirty();
+      }
+
 //-------------------------------------------------------------------
 //   mmRestFirst
 //    this is a multi measure rest
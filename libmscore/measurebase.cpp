@@ -343,6 +343,32 @@ Fraction MeasureBase::tick() const
       return mb ? mb->_tick : Fraction(-1, 1);
       }
 
+//---------------------------------------------------------
+//   setTick
+//---------------------------------------------------------
+
+void MeasureBase::setTick(const Fraction& f)
+      {
+      if (_tick == f)
+            return;
+      _tick = f;
+      if (score())
+            score()->setMeasureTickIndexDirty();
+      }
+
+//---------------------------------------------------------
+//   setNext
+//---------------------------------------------------------
+
+void MeasureBase::setNext(MeasureBase* e)
+      {
+      if (_next == e)
+            return;
+      _next = e;
+      if (score())
+            score()->setMeasureTickIndexDirty();
+      }
+
 //---------------------------------------------------------
 //   triggerLayout
 //---------------------------------------------------------
@@ -84,7 +84,7 @@ class MeasureBase : public Element {
 
       MeasureBase* next() const              { return _next;   }
       MeasureBase* nextMM() const;
-      void setNext(MeasureBase* e)           { _next = e;      }
+      void setNext(MeasureBase* e);
       MeasureBase* prev() const              { return _prev;   }
       MeasureBase* prevMM() const;
       void setPrev(MeasureBase* e)           { _prev = e;      }
@@ -123,7 +123,7 @@ class MeasureBase : public Element {
       virtual bool readProperties(XmlReader&) override;
 
       Fraction tick() const override;
-      void setTick(const Fraction& f)      { _tick = f;    }
+      void setTick(const Fraction& f);
 
       Fraction ticks() const               { return _len;         }
       void setTicks(const Fraction& f)     { _len = f;            }
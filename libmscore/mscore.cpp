@@ -59,6 +59,9 @@
 
 namespace Ms {
 
+static QMultiHash<QString, QString> lazyFonts;  // lower case family -> internal font files not loaded yet
+static QMutex lazyFontsMutex;                   // loadFont() is also called while pages are painted in parallel
+
 bool MScore::debugMode = false;
 bool MScore::testMode = false;
 
@@ -359,34 +362,39 @@ void MScore::init()
       // for MAC, they are in Resources/fonts
       //
 #if !defined(Q_OS_MAC) && !defined(Q_OS_IOS)
-      static const char* fonts[] = {
-            "/fonts/musejazz/MuseJazzText.woff2",
-            "/fonts/campania/Campania.woff2",
-            "/fonts/edwin/Edwin-Roman.woff2",
-            "/fonts/edwin/Edwin-Bold.woff2",
-            "/fonts/edwin/Edwin-Italic.woff2",
-            "/fonts/edwin/Edwin-BdIta.woff2",
-            "/fonts/FreeSans.woff2",
-            "/fonts/FreeSerif.woff2",
-            "/fonts/FreeSerifBold.woff2",
-            "/fonts/FreeSerifItalic.woff2",
-            "/fonts/FreeSerifBoldItalic.woff2",
-            "/fonts/mscoreTab.woff2",
-            "/fonts/mscore-BC.woff2",
-            "/fonts/leland/LelandText.woff2",
-            "/fonts/bravura/BravuraText.woff2",
-            "/fonts/gootville/GootvilleText.woff2",
-            "/fonts/mscore/MScoreText.woff2",
-            "/fonts/petaluma/PetalumaText.woff2",
-            "/fonts/petaluma/PetalumaScript.woff2",
+      static const struct {
+            const char* family;
+            const char* path;
+            } fonts[] = {
+            { "MuseJazz Text",    MS_DATA_PATH("/fonts/musejazz/MuseJazzText.woff2")     },
+            { "Campania",         MS_DATA_PATH("/fonts/campania/Campania.woff2")         },
+            { "Edwin",            MS_DATA_PATH("/fonts/edwin/Edwin-Roman.woff2")         },
+            { "Edwin",            MS_DATA_PATH("/fonts/edwin/Edwin-Bold.woff2")          },
+            { "Edwin",            MS_DATA_PATH("/fonts/edwin/Edwin-Italic.woff2")        },
+            { "Edwin",            MS_DATA_PATH("/fonts/edwin/Edwin-BdIta.woff2")         },
+            { "FreeSans",         MS_DATA_PATH("/fonts/FreeSans.woff2")                  },
+            { "FreeSerif",        MS_DATA_PATH("/fonts/FreeSerif.woff2")                 },
+            { "FreeSerif",        MS_DATA_PATH("/fonts/FreeSerifBold.woff2")             },
+            { "FreeSerif",        MS_DATA_PATH("/fonts/FreeSerifItalic.woff2")           },
+            { "FreeSerif",        MS_DATA_PATH("/fonts/FreeSerifBoldItalic.woff2")       },
+            { "MScoreTabulature", MS_DATA_PATH("/fonts/mscoreTab.woff2")                 },
+            { "MScoreBC",         MS_DATA_PATH("/fonts/mscore-BC.woff2")                 },
+            { "Leland Text",      MS_DATA_PATH("/fonts/leland/LelandText.woff2")         },
+            { "Bravura Text",     MS_DATA_PATH("/fonts/bravura/BravuraText.woff2")       },
+            { "Gootville Text",   MS_DATA_PATH("/fonts/gootville/GootvilleText.woff2")   },
+            { "MScore Text",      MS_DATA_PATH("/fonts/mscore/MScoreText.woff2")         },
+            { "Petaluma Text",    MS_DATA_PATH("/fonts/petaluma/PetalumaText.woff2")     },
+            { "Petaluma Script",  MS_DATA_PATH("/fonts/petaluma/PetalumaScript.woff2")   },
             };
 
-      for (unsigned i = 0; i < sizeof(fonts)/sizeof(*fonts); ++i) {
-            QString str(fonts[i]);
-            if (-1 == QFontDatabase::addApplicationFont(str)) {
-                  qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(str));
+      for (const auto& font : fonts) {
+            // without gui, the fonts are only loaded when used, see loadFont();
+            // the gui lists the families of QFontDatabase
+            if (noGui)
+                  lazyFonts.insert(QString(font.family).toLower(), font.path);
+            else if (-1 == QFontDatabase::addApplicationFont(font.path))
+                  qDebug("Mscore: fatal error: cannot load internal font <%s>", font.path);
             }
-      }
 #endif
 // Workaround for QTBUG-73241 (solved in Qt 5.12.2) in Windows 10, see https://musescore.org/en/node/280244
 #if defined(Q_OS_WIN) && (QT_VERSION < QT_VERSION_CHECK(5, 12, 2))
@@ -413,6 +421,31 @@ if (QOperatingSystemVersion::current().majorVersion() >= 10) {
       initDone = true;
       }
 
+//---------------------------------------------------------
+//   loadFont
+//    register the internal font files of family with
+//    QFontDatabase, the first time the family is used.
+//    Decompressing (woff2) and setting up a font is slow,
+//    and most scores only use a few of them.
+//    Thread safe.
+//---------------------------------------------------------
+
+void MScore::loadFont(const QString& family)
+      {
+      QMutexLocker locker(&lazyFontsMutex);
+      if (lazyFonts.isEmpty())
+            return;
+      const QString key = family.toLower();
+      const QStringList paths = lazyFonts.values(key);
+      if (paths.isEmpty())
+            return;
+      lazyFonts.remove(key);
+      for (const QString& path : paths) {
+            if (-1 == QFontDatabase::addApplicationFont(path))
+                  qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(path));
+            }
+      }
+
 //---------------------------------------------------------
 //   readDefaultStyle
 //---------------------------------------------------------
@@ -74,6 +74,14 @@ enum class HairpinType : signed char;
 #define VOICES 4
 #endif
 
+// the data files (fonts, styles) are at the root of the emscripten file system,
+// the native build (WEBMSCORE_NATIVE) embeds them as Qt resources instead
+#ifdef WEBMSCORE_NATIVE
+#define MS_DATA_PATH(path) ":" path
+#else
+#define MS_DATA_PATH(path) path
+#endif
+
 inline int staff2track(int staffIdx) { return staffIdx << 2; }
 inline int track2staff(int voice)    { return voice >> 2;    }
 inline int track2voice(int track)    { return track & 3;     }
@@ -309,6 +317,7 @@ class MScore {
       static std::vector<MScoreError> errorList;
 
       static void init();
+      static void loadFont(const QString& family);
 
       static MStyle& baseStyle()                   { return _baseStyle;            }
       static void setBaseStyle(const MStyle& style) { _baseStyle = style;          }
@@ -144,6 +144,8 @@ void Page::draw(QPainter* painter) const
 
 //---------------------------------------------------------
 //   drawHeaderFooter
+//    the header and footer texts are shared by all pages
+//    of the score, pages painted in parallel take turns
 //---------------------------------------------------------
 
 void Page::drawHeaderFooter(QPainter* p, int area, const QString& ss) const
@@ -152,6 +154,8 @@ void Page::drawHeaderFooter(QPainter* p, int area, const QString& ss) const
       if (s.isEmpty())
             return;
 
+      static QMutex mutex;
+      QMutexLocker locker(&mutex);
       Text* text;
       if (area < MAX_HEADERS) {
             text = score()->headerText(area);
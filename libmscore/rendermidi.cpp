@@ -18,6 +18,7 @@
 #include <set>
 
 #include "rendermidi.h"
+#include "taskpool.h"
 #include "score.h"
 #include "volta.h"
 #include "note.h"
@@ -1057,6 +1058,35 @@ void MidiRenderer::renderStaffChunk(const Chunk& chunk, EventMap* events, const
             }
       }
 
+//---------------------------------------------------------
+//   renderStavesChunk
+//    Staves only read the score, and write their own events,
+//    so they can be rendered in parallel, each into its own
+//    EventMap. These are appended in staff order, so the
+//    result is the same as rendering them one after another.
+//---------------------------------------------------------
+
+void MidiRenderer::renderStavesChunk(const Chunk& chunk, EventMap* events, const std::vector<StaffContext>& sctxs)
+      {
+      const int nstaves = int(sctxs.size());
+      TaskPool* pool = TaskPool::instance();
+      if (pool->threads() <= 1 || nstaves <= 1) {
+            for (const StaffContext& sctx : sctxs)
+                  renderStaffChunk(chunk, events, sctx);
+            return;
+            }
+      // the lazily built lookups are only safe from several threads once built
+      score->spannerMap().updateIfDirty();
+      score->updateMeasureTickIndex();
+      std::vector<EventMap> staffEvents(nstaves);
+      pool->parallelFor(nstaves, [&](int i) {
+            renderStaffChunk(chunk, &staffEvents[i], sctxs[i]);
+            });
+
+      for (const EventMap& e : staffEvents)
+            events->append(e);
+      }
+
 //---------------------------------------------------------
 //   renderSpanners
 //---------------------------------------------------------
@@ -2364,14 +2394,16 @@ void MidiRenderer::renderChunk(const Chunk& chunk, EventMap* events, const Conte
             }
 
       // create note & other events
+      std::vector<StaffContext> sctxs;
       for (Staff* st : score->staves()) {
             StaffContext sctx;
             sctx.staff = st;
             sctx.method = renderMethod;
             sctx.cc = cc;
             sctx.renderHarmony = ctx.renderHarmony;
-            renderStaffChunk(chunk, events, sctx);
+            sctxs.push_back(sctx);
             }
+      renderStavesChunk(chunk, events, sctxs);
       events->fixupMIDI();
 
       // create sustain pedal events
@@ -2382,28 +2414,28 @@ void MidiRenderer::renderChunk(const Chunk& chunk, EventMap* events, const Conte
 
       // NOTE:JT this is a temporary fix for duplicate events until polyphonic aftertouch support
       // can be implemented. This removes duplicate SND events.
+      // The events are compacted in place, erasing them one by one would be quadratic.
       int lastChannel = -1;
       int lastController = -1;
       int lastValue = -1;
-      for (auto i = events->begin(); i != events->end();) {
+      auto out = events->begin();
+      for (auto i = events->begin(); i != events->end(); ++i) {
             if (i->second.type() == ME_CONTROLLER) {
-                  auto& event = i->second;
+                  const auto& event = i->second;
                   if (event.channel() == lastChannel &&
                      event.controller() == lastController &&
                      event.value() == lastValue) {
-                        i = events->erase(i);
-                        }
-                  else {
-                        lastChannel = event.channel();
-                        lastController = event.controller();
-                        lastValue = event.value();
-                        i++;
+                        continue;
                         }
+                  lastChannel = event.channel();
+                  lastController = event.controller();
+                  lastValue = event.value();
                   }
-            else {
-                  i++;
-                  }
+            if (out != i)
+                  *out = std::move(*i);
+            ++out;
             }
+      events->erase(out, events->end());
       }
 
 //---------------------------------------------------------
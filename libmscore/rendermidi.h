@@ -105,6 +105,7 @@ class MidiRenderer {
       void updateState();
 
       void renderStaffChunk(const Chunk&, EventMap* events, const StaffContext& sctx);
+      void renderStavesChunk(const Chunk&, EventMap* events, const std::vector<StaffContext>& sctxs);
       void renderSpanners(const Chunk&, EventMap* events);
       void renderMetronome(const Chunk&, EventMap* events);
       void renderMetronome(EventMap* events, Measure const * m, const Fraction& tickOffset);
@@ -217,6 +217,7 @@ qreal RepeatList::utick2utime(int tick) const
       unsigned ii = (idx1 < n) && (tick >= at(idx1)->utick) ? idx1 : 0;
       for (unsigned i = ii; i < n; ++i) {
             if ((tick >= at(i)->utick) && ((i + 1 == n) || (tick < at(i+1)->utick))) {
+                  idx1 = i;
                   int t     = tick - (at(i)->utick - at(i)->tick);
                   qreal tt = _score->tempomap()->tick2time(t) + at(i)->timeOffset;
                   return tt;
@@ -225,6 +226,103 @@ qreal RepeatList::utick2utime(int tick) const
       return 0.0;
       }
 
+//---------------------------------------------------------
+//   utick2utime
+//    convert n uticks at once, fastest if they are sorted
+//---------------------------------------------------------
+
+void RepeatList::utick2utime(const int* uticks, qreal* utimes, int n) const
+      {
+      TimeCursor cursor(*this);
+      for (int i = 0; i < n; ++i)
+            utimes[i] = cursor.utick2utime(uticks[i]);
+      }
+
+//---------------------------------------------------------
+//   TimeCursor
+//---------------------------------------------------------
+
+TimeCursor::TimeCursor(const RepeatList& rl)
+   : _repeatList(&rl), _tempomap(rl.score()->tempomap())
+      {
+      reset();
+      }
+
+//---------------------------------------------------------
+//   reset
+//---------------------------------------------------------
+
+void TimeCursor::reset()
+      {
+      _tempoSN   = _tempomap->tempoSN();
+      _segIdx    = 0;
+      _tempoNext = _tempomap->begin();
+      }
+
+//---------------------------------------------------------
+//   tick2time
+//    same result as TempoMap::tick2time(), but searches
+//    the tempo map only when going backwards
+//---------------------------------------------------------
+
+qreal TimeCursor::tick2time(int tick)
+      {
+      if (_tempoNext != _tempomap->begin()) {
+            auto cur = _tempoNext;
+            --cur;
+            if (tick < cur->first)
+                  _tempoNext = _tempomap->upper_bound(tick);
+            }
+      while (_tempoNext != _tempomap->end() && _tempoNext->first <= tick)
+            ++_tempoNext;
+
+      qreal time  = 0.0;
+      qreal delta = qreal(tick);
+      qreal tempo = 2.0;
+      if (!_tempomap->empty()) {
+            int ptick = 0;
+            if (_tempoNext != _tempomap->begin()) {
+                  auto e = _tempoNext;
+                  --e;
+                  ptick = e->first;
+                  tempo = e->second.tempo;
+                  time  = e->second.time;
+                  }
+            delta = qreal(tick - ptick);
+            }
+      time += delta / (MScore::division * tempo * _tempomap->relTempo());
+      return time;
+      }
+
+//---------------------------------------------------------
+//   utick2utime
+//---------------------------------------------------------
+
+qreal TimeCursor::utick2utime(int utick)
+      {
+      if (_tempomap->tempoSN() != _tempoSN)
+            reset();
+      const RepeatList& rl = *_repeatList;
+      const int n = rl.size();
+      if (n == 0)
+            return 0.0;
+
+      if (_segIdx >= n || utick < rl.at(_segIdx)->utick) {
+            // going backwards: binary search for the last segment starting at or before utick
+            auto it = std::upper_bound(rl.cbegin(), rl.cend(), utick, [](int t, const RepeatSegment* rs) {
+                  return t < rs->utick;
+                  });
+            if (it == rl.cbegin())
+                  return 0.0;
+            _segIdx = (it - rl.cbegin()) - 1;
+            }
+      while (_segIdx + 1 < n && utick >= rl.at(_segIdx + 1)->utick)
+            ++_segIdx;
+
+      const RepeatSegment* rs = rl.at(_segIdx);
+      return tick2time(utick - (rs->utick - rs->tick)) + rs->timeOffset;
+      }
+
 //---------------------------------------------------------
 //   utime2utick
 //---------------------------------------------------------
@@ -13,6 +13,8 @@
 #ifndef __REPEATLIST_H__
 #define __REPEATLIST_H__
 
+#include "tempo.h"
+
 namespace Ms {
 
 class Score;
@@ -89,12 +91,38 @@ class RepeatList: public QList<RepeatSegment*>
       int tick2utick(int tick) const;
       int utime2utick(qreal) const;
       qreal utick2utime(int) const;
+      void utick2utime(const int* uticks, qreal* utimes, int n) const;
       void updateTempo();
       int ticks() const;
 
       QList<RepeatSegment*>::const_iterator findRepeatSegmentFromUTick(int utick) const;
       };
 
+//---------------------------------------------------------
+//   TimeCursor
+//    utick -> time conversion like RepeatList::utick2utime()
+//    for a sequence of (mostly) increasing uticks, e.g. while
+//    playing back or exporting. The current repeat segment and
+//    tempo map position are kept between calls, so sequential
+//    access costs amortized O(1) instead of a search per call.
+//    A cursor must not outlive changes of the repeat list.
+//---------------------------------------------------------
+
+class TimeCursor {
+      const RepeatList* _repeatList;
+      const TempoMap* _tempomap;
+      int _tempoSN;
+      int _segIdx { 0 };
+      TempoMap::const_iterator _tempoNext;      // first tempo event after the current tick
+
+      void reset();
+      qreal tick2time(int tick);
+
+   public:
+      TimeCursor(const RepeatList& rl);
+      qreal utick2utime(int utick);
+      };
+
 
 }     // namespace Ms
 #endif
@@ -61,6 +61,7 @@
 #include "tiemap.h"
 #include "layoutbreak.h"
 #include "harmony.h"
+#include "fret.h"
 #include "mscore.h"
 #include "scoreOrder.h"
 #ifdef OMR
@@ -366,7 +367,7 @@ Score* Score::clone()
 
       XmlReader r(buffer.buffer());
       MasterScore* score = new MasterScore(style());
-      score->read1(r, true);
+      score->read1(r, true, buffer.buffer());
 
       score->addLayoutFlags(LayoutFlag::FIX_PITCH_VELO);
       score->doLayout();
@@ -2017,7 +2018,7 @@ MasterScore* MasterScore::clone()
 
       XmlReader r(buffer.buffer());
       MasterScore* score = new MasterScore(style());
-      score->read1(r, true);
+      score->read1(r, true, buffer.buffer());
 
       score->addLayoutFlags(LayoutFlag::FIX_PITCH_VELO);
       score->doLayout();
@@ -4501,6 +4502,106 @@ int Score::durationWithoutRepeats()
       return lrint(utick2utime(rs->utick + rs->len()));
       }
 
+//---------------------------------------------------------
+//   collectFrameText
+//    scanElements() callback for Score::statistics()
+//---------------------------------------------------------
+
+static void collectFrameText(void* data, Element* e)
+      {
+      if (!e->isTextBase())
+            return;
+      ScoreStatistics* stats = static_cast<ScoreStatistics*>(data);
+      TextBase* text = toTextBase(e);
+      switch (text->tid()) {
+            case Tid::TITLE:
+                  stats->titles.append(text->plainText());
+                  break;
+            case Tid::SUBTITLE:
+                  stats->subtitles.append(text->plainText());
+                  break;
+            case Tid::COMPOSER:
+                  stats->composers.append(text->plainText());
+                  break;
+            case Tid::POET:
+                  stats->poets.append(text->plainText());
+                  break;
+            default:
+                  break;
+            }
+      }
+
+//---------------------------------------------------------
+//   statistics
+//    The metadata of hasLyrics(), hasHarmonies(),
+//    Part::lyricCount(), Part::harmonyCount() (one walk over
+//    the segments), the last tempo text (one walk over the
+//    segments with multi measure rests), the frame texts
+//    (one scanElements()), durationDouble() and
+//    extractLyrics().
+//    Cached until the undo stack moves to another state.
+//---------------------------------------------------------
+
+const ScoreStatistics& Score::statistics()
+      {
+      const ScoreContentState curState = state();
+      if (_statistics && _statisticsState == curState)
+            return *_statistics;
+
+      _statistics.reset(new ScoreStatistics);
+      _statisticsState = curState;
+      ScoreStatistics& stats = *_statistics;
+
+      std::vector<ScoreStatistics::PartCounts> partCounts(_parts.size());
+      std::vector<ScoreStatistics::PartCounts*> trackCounts(ntracks(), nullptr);
+      for (int i = 0; i < _parts.size(); ++i) {
+            for (int track = _parts[i]->startTrack(); track < _parts[i]->endTrack() && track < ntracks(); ++track)
+                  trackCounts[track] = &partCounts[i];
+            }
+
+      int lyricCount = 0;
+      for (Segment* seg = firstSegment(SegmentType::ChordRest); seg; seg = seg->next1(SegmentType::ChordRest)) {
+            for (int track = 0; track < ntracks(); ++track) {
+                  ChordRest* cr = toChordRest(seg->element(track));
+                  if (!cr || cr->lyrics().empty())
+                        continue;
+                  lyricCount += int(cr->lyrics().size());
+                  if (trackCounts[track])
+                        trackCounts[track]->lyricCount += int(cr->lyrics().size());
+                  }
+            for (Element* e : seg->annotations()) {
+                  if (e->isHarmony() || (e->isFretDiagram() && toFretDiagram(e)->harmony())) {
+                        if (e->isHarmony())
+                              stats.hasHarmonies = true;
+                        if (e->track() >= 0 && e->track() < ntracks() && trackCounts[e->track()])
+                              trackCounts[e->track()]->harmonyCount++;
+                        }
+                  }
+            }
+      stats.hasLyrics = lyricCount > 0;
+      for (int i = 0; i < _parts.size(); ++i)
+            stats.parts.insert(_parts[i], partCounts[i]);
+
+      // the last tempo text, following the multi measure rests
+      for (Segment* seg = firstSegmentMM(SegmentType::All); seg; seg = seg->next1MM()) {
+            for (Element* e : seg->annotations()) {
+                  if (e->isTempoText()) {
+                        TempoText* tt = toTempoText(e);
+                        stats.tempo = round(tt->tempo() * 60);
+                        stats.tempoText = tt->xmlText();
+                        }
+                  }
+            }
+
+      scanElements(&stats, collectFrameText);
+
+      stats.duration = durationDouble();
+      // without lyrics, extractLyrics() only walks the repeats to return ""
+      if (stats.hasLyrics)
+            stats.lyrics = extractLyrics();
+      return stats;
+      }
+
 //---------------------------------------------------------
 //   createRehearsalMarkText
 //---------------------------------------------------------
@@ -166,6 +166,31 @@ class MeasureBaseList {
       int size() const { return _size; }
       };
 
+//---------------------------------------------------------
+//   MeasureTickIndex
+//    start ticks of the measures of a score in score order,
+//    for binary searched tick -> measure lookups.
+//    Rebuilt lazily after the measure list, a measure tick
+//    or a multi measure rest changed. Not thread safe while
+//    invalid, see Score::updateMeasureTickIndex().
+//---------------------------------------------------------
+
+class MeasureTickIndex {
+      std::vector<Fraction> _ticks;
+      std::vector<Measure*> _measures;
+      Measure* _first { 0 };
+      bool _valid     { false };
+      bool _sorted    { true  };
+      bool _mmRests   { false };      // built following multi measure rests
+
+   public:
+      bool isValid(Measure* first, bool mmRests) const { return _valid && _first == first && _mmRests == mmRests; }
+      void invalidate()                                { _valid = false; }
+      void rebuild(Measure* first, bool mmRests);
+      bool sorted() const                              { return _sorted; }
+      Measure* find(const Fraction& tick) const;
+      };
+
 //---------------------------------------------------------
 //   MidiMapping
 //---------------------------------------------------------
@@ -340,6 +365,31 @@ class ScoreContentState {
       bool isNewerThan(const ScoreContentState& s2) const { return score == s2.score && num > s2.num; }
       };
 
+//---------------------------------------------------------
+//   ScoreStatistics
+//    metadata of a score, collected together,
+//    see Score::statistics()
+//---------------------------------------------------------
+
+struct ScoreStatistics {
+      struct PartCounts {
+            int lyricCount   { 0 };
+            int harmonyCount { 0 };
+            };
+
+      QStringList titles;                 // text of every TITLE, SUBTITLE, COMPOSER, POET text,
+      QStringList subtitles;              // in scanElements() order
+      QStringList composers;
+      QStringList poets;
+      bool hasLyrics    { false };
+      bool hasHarmonies { false };
+      QHash<const Part*, PartCounts> parts;
+      int tempo         { 0 };            // the last tempo text, bpm
+      QString tempoText;
+      qreal duration    { 0.0 };          // seconds, repeats expanded
+      QString lyrics;                     // extractLyrics()
+      };
+
 class MasterScore;
 
 //-----------------------------------------------------------------------------
@@ -439,6 +489,8 @@ class Score : public QObject, public ScoreElement {
       UpdateState _updateState;
 
       MeasureBaseList _measures;          // here are the notes
+      mutable MeasureTickIndex _tickIndex;      // for tick2measure()
+      mutable MeasureTickIndex _tickIndexMM;    // for tick2measureMM()
       QList<Part*> _parts;
       QList<Staff*> _staves;
 
@@ -488,6 +540,8 @@ class Score : public QObject, public ScoreElement {
       PlayMode _playMode { PlayMode::SYNTHESIZER };
 
       qreal _noteHeadWidth { 0.0 };       // cached value
+      std::unique_ptr<ScoreStatistics> _statistics;
+      ScoreContentState _statisticsState; // undo state _statistics were collected at
       QString accInfo;                    ///< information about selected element(s) for use by screen-readers
       QString accMessage;                 ///< temporary status message for use by screen-readers
 
@@ -836,6 +890,8 @@ class Score : public QObject, public ScoreElement {
       Fraction pos();
       Measure* tick2measure(const Fraction& tick) const;
       Measure* tick2measureMM(const Fraction& tick) const;
+      void setMeasureTickIndexDirty()    { _tickIndex.invalidate(); _tickIndexMM.invalidate(); }
+      void updateMeasureTickIndex() const;
       MeasureBase* tick2measureBase(const Fraction& tick) const;
       Segment* tick2segment(const Fraction& tick, bool first, SegmentType st, bool useMMrest = false) const;
       Segment* tick2segment(const Fraction& tick) const;
@@ -1187,6 +1243,7 @@ class Score : public QObject, public ScoreElement {
       int duration();
       qreal durationDouble();
       int durationWithoutRepeats();
+      const ScoreStatistics& statistics();
 
       void cmdInsertClef(Clef* clef, ChordRest* cr);
 
@@ -1255,6 +1312,7 @@ class Score : public QObject, public ScoreElement {
       friend class Chord;
 
       std::function<SynthRes*(bool)> synthFn;
+      std::function<SynthRes*(bool)> encodeFn;
       };
 
 static inline Score* toScore(ScoreElement* e) {
@@ -1374,7 +1432,7 @@ class MasterScore : public Score {
       void setTempomap(TempoMap* tm);
 
       bool saveFile(bool generateBackup = true);
-      FileError read1(XmlReader&, bool ignoreVersionError);
+      FileError read1(XmlReader&, bool ignoreVersionError, const QByteArray& data);
       FileError loadCompressedMsc(QIODevice*, bool ignoreVersionError);
       FileError loadMsc(QString name, bool ignoreVersionError);
       FileError loadMsc(QString name, QIODevice*, bool ignoreVersionError);
@@ -1383,7 +1441,7 @@ class MasterScore : public Score {
       FileError read302(XmlReader&);
       QByteArray readToBuffer();
       QByteArray readCompressedToBuffer();
-      int readStyleDefaultsVersion();
+      int readStyleDefaultsVersion(const QByteArray& data);
       int styleDefaultByMscVersion(const int mscVer) const;
 
       Omr* omr() const                         { return _omr;     }
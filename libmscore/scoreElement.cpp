@@ -812,15 +812,72 @@ QString ScoreElement::userName() const
       }
 
 //---------------------------------------------------------
-//   name2type
+//   ElementNameTable
+//    hash table of the elementNames, built once,
+//    so name2type does not compare against every name
 //---------------------------------------------------------
 
-ElementType ScoreElement::name2type(const QStringRef& s, bool silent)
+class ElementNameTable {
+      static const int SIZE = 512;  // power of 2, some times the number of element types
+      short _types[SIZE];
+
+      static uint hash(const char* s, int n);
+      static uint hash(const QChar* s, int n);
+
+   public:
+      ElementNameTable();
+      ElementType find(const QStringRef& s) const;
+      };
+
+uint ElementNameTable::hash(const char* s, int n)
+      {
+      uint h = 2166136261u;
+      for (int i = 0; i < n; ++i)
+            h = (h ^ uchar(s[i])) * 16777619u;
+      return h;
+      }
+
+uint ElementNameTable::hash(const QChar* s, int n)
+      {
+      uint h = 2166136261u;
+      for (int i = 0; i < n; ++i)
+            h = (h ^ s[i].unicode()) * 16777619u;
+      return h;
+      }
+
+ElementNameTable::ElementNameTable()
       {
+      static_assert(int(ElementType::MAXTYPE) * 2 < SIZE, "ElementNameTable too small");
+      std::fill(std::begin(_types), std::end(_types), -1);
       for (int i = 0; i < int(ElementType::MAXTYPE); ++i) {
+            uint h = hash(elementNames[i].name, int(strlen(elementNames[i].name)));
+            while (_types[h & (SIZE - 1)] != -1)
+                  ++h;
+            _types[h & (SIZE - 1)] = short(i);
+            }
+      }
+
+ElementType ElementNameTable::find(const QStringRef& s) const
+      {
+      for (uint h = hash(s.unicode(), s.size());; ++h) {
+            int i = _types[h & (SIZE - 1)];
+            if (i == -1)
+                  return ElementType::INVALID;
             if (s == elementNames[i].name)
                   return ElementType(i);
             }
+      }
+
+//---------------------------------------------------------
+//   name2type
+//---------------------------------------------------------
+
+ElementType ScoreElement::name2type(const QStringRef& s, bool silent)
+      {
+      static const ElementNameTable table;
+      ElementType type = table.find(s);
+      if (type != ElementType::INVALID || s == elementNames[int(ElementType::INVALID)].name)
+            return type;
       if (!silent)
             qDebug("unknown type <%s>", qPrintable(s.toString()));
       return ElementType::INVALID;
@@ -251,7 +251,7 @@ void Score::writeMovement(XmlWriter& xml, bool selectionOnly)
       if (isMaster()) {
             if (!selectionOnly) {
                   for (const Excerpt* excerpt : excerpts()) {
-                        if (excerpt->partScore() != this)
+                        if (excerpt->partScore() && excerpt->partScore() != this)
                               excerpt->partScore()->write(xml, false);       // recursion
                         }
                   }
@@ -865,7 +865,7 @@ Score::FileError MasterScore::loadCompressedMsc(QIODevice* io, bool ignoreVersio
       XmlReader e(dbuf);
       e.setDocName(masterScore()->fileInfo()->completeBaseName());
 
-      FileError retval = read1(e, ignoreVersionError);
+      FileError retval = read1(e, ignoreVersionError, dbuf);
 
 #ifdef OMR
       //
@@ -914,18 +914,37 @@ int MasterScore::styleDefaultByMscVersion(const int mscVer) const
       return MSCVERSION;
       }
 
-int MasterScore::readStyleDefaultsVersion()
+//---------------------------------------------------------
+//   readStyleDefaultsVersion
+//    data: the score file content being read
+//    Only the first <Style> block is scanned for
+//    <defaultsVersion>, without tokenizing the whole file.
+//---------------------------------------------------------
+
+int MasterScore::readStyleDefaultsVersion(const QByteArray& data)
       {
       if (styleB(Sid::usePre_3_6_defaults))
             return style().defaultStyleVersion();
 
-      XmlReader e(readToBuffer());
-      e.setDocName(masterScore()->fileInfo()->completeBaseName());
-
-      while (!e.atEnd()) {
-            e.readNext();
-            if (e.name() == "defaultsVersion")
-                  return e.readInt();
+      static const QByteArray styleTag("<Style>");
+      static const QByteArray styleEndTag("</Style>");
+      static const QByteArray versionTag("<defaultsVersion>");
+
+      const int styleBegin = data.indexOf(styleTag);
+      if (styleBegin != -1) {
+            int styleEnd = data.indexOf(styleEndTag, styleBegin);
+            if (styleEnd == -1)
+                  styleEnd = data.size();
+            const QByteArray style = QByteArray::fromRawData(data.constData() + styleBegin, styleEnd - styleBegin);
+            const int versionBegin = style.indexOf(versionTag);
+            if (versionBegin != -1) {
+                  const int valueBegin = versionBegin + versionTag.size();
+                  const int valueEnd = style.indexOf('<', valueBegin);
+                  bool ok = false;
+                  const int version = style.mid(valueBegin, valueEnd - valueBegin).trimmed().toInt(&ok);
+                  if (ok)
+                        return version;
+                  }
             }
 
       return styleDefaultByMscVersion(mscVersion());
@@ -954,8 +973,12 @@ Score::FileError MasterScore::loadMsc(QString name, QIODevice* io, bool ignoreVe
       if (name.endsWith(".mscz") || name.endsWith(".mscz,"))
             return loadCompressedMsc(io, ignoreVersionError);
       else {
-            XmlReader r(io);
-            return read1(r, ignoreVersionError);
+            // the content is needed twice (style defaults version, actual read),
+            // so read it once instead of going back to the file
+            QBuffer* buffer = qobject_cast<QBuffer*>(io);
+            const QByteArray data = buffer ? buffer->data() : io->readAll();
+            XmlReader r(data);
+            return read1(r, ignoreVersionError, data);
             }
       }
 
@@ -1013,10 +1036,12 @@ void MasterScore::parseVersion(const QString& val)
 
 //---------------------------------------------------------
 //   read1
+//    data: the content read by e, used to look up the
+//          style defaults version ahead of the actual read
 //    return true on success
 //---------------------------------------------------------
 
-Score::FileError MasterScore::read1(XmlReader& e, bool ignoreVersionError)
+Score::FileError MasterScore::read1(XmlReader& e, bool ignoreVersionError, const QByteArray& data)
       {
       while (e.readNextStartElement()) {
             if (e.name() == "museScore") {
@@ -1033,7 +1058,7 @@ Score::FileError MasterScore::read1(XmlReader& e, bool ignoreVersionError)
                               return FileError::FILE_OLD_300_FORMAT;
                         }
 
-                  int defaultsVersion = readStyleDefaultsVersion();
+                  int defaultsVersion = readStyleDefaultsVersion(data);
 
                   setStyle(*MStyle::resolveStyleDefaults(defaultsVersion));
                   style().setDefaultStyleVersion(defaultsVersion);
@@ -1060,8 +1085,11 @@ Score::FileError MasterScore::read1(XmlReader& e, bool ignoreVersionError)
 
 void Score::print(QPainter* painter, int pageNo)
       {
+      // not written when already set, scores may be printed in parallel
+      const bool pdfPrinting = MScore::pdfPrinting;
       _printing  = true;
-      MScore::pdfPrinting = true;
+      if (!pdfPrinting)
+            MScore::pdfPrinting = true;
       Page* page = pages().at(pageNo);
       QRectF fr  = page->abbox();
 
@@ -1075,7 +1103,8 @@ void Score::print(QPainter* painter, int pageNo)
             e->draw(painter);
             painter->restore();
             }
-      MScore::pdfPrinting = false;
+      if (!pdfPrinting)
+            MScore::pdfPrinting = false;
       _printing = false;
       }
 
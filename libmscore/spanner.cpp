@@ -1057,7 +1057,7 @@ void Spanner::setTick(const Fraction& v)
       {
       _tick = v;
       if (score())
-            score()->spannerMap().setDirty();
+            score()->spannerMap().moveSpanner(this);
       }
 
 //---------------------------------------------------------
@@ -1077,7 +1077,7 @@ void Spanner::setTicks(const Fraction& f)
       {
       _ticks = f;
       if (score())
-            score()->spannerMap().setDirty();
+            score()->spannerMap().moveSpanner(this);
       }
 
 //---------------------------------------------------------
@@ -13,6 +13,8 @@
 #include "spannermap.h"
 #include "spanner.h"
 
+#include <algorithm>
+
 namespace Ms {
 
 //---------------------------------------------------------
@@ -22,20 +24,164 @@ namespace Ms {
 SpannerMap::SpannerMap()
       : std::multimap<int, Spanner*>()
       {
-      dirty = true;
+      dirty   = false;
+      root    = -1;
+      nextSeq = 0;
+      }
+
+//---------------------------------------------------------
+//   less
+//---------------------------------------------------------
+
+bool SpannerMap::less(const Node& a, const Node& b) const
+      {
+      return a.start < b.start || (a.start == b.start && a.seq < b.seq);
+      }
+
+//---------------------------------------------------------
+//   pull
+//    recompute maxStop of node n from its children
+//---------------------------------------------------------
+
+void SpannerMap::pull(int n) const
+      {
+      Node& node = nodes[n];
+      node.maxStop = node.stop;
+      if (node.left != -1)
+            node.maxStop = std::max(node.maxStop, nodes[node.left].maxStop);
+      if (node.right != -1)
+            node.maxStop = std::max(node.maxStop, nodes[node.right].maxStop);
+      }
+
+//---------------------------------------------------------
+//   split
+//    split tree t into nodes before k (l) and the others (r)
+//---------------------------------------------------------
+
+void SpannerMap::split(int t, const Node& k, int* l, int* r) const
+      {
+      if (t == -1) {
+            *l = *r = -1;
+            return;
+            }
+      if (less(nodes[t], k)) {
+            split(nodes[t].right, k, &nodes[t].right, r);
+            *l = t;
+            }
+      else {
+            split(nodes[t].left, k, l, &nodes[t].left);
+            *r = t;
+            }
+      pull(t);
+      }
+
+//---------------------------------------------------------
+//   merge
+//    all nodes of l are before the nodes of r
+//---------------------------------------------------------
+
+int SpannerMap::merge(int l, int r) const
+      {
+      if (l == -1)
+            return r;
+      if (r == -1)
+            return l;
+      if (nodes[l].priority > nodes[r].priority) {
+            nodes[l].right = merge(nodes[l].right, r);
+            pull(l);
+            return l;
+            }
+      nodes[r].left = merge(l, nodes[r].left);
+      pull(r);
+      return r;
+      }
+
+//---------------------------------------------------------
+//   insertNode
+//---------------------------------------------------------
+
+void SpannerMap::insertNode(int n) const
+      {
+      nodes[n].left  = -1;
+      nodes[n].right = -1;
+      pull(n);
+      int l;
+      int r;
+      split(root, nodes[n], &l, &r);
+      root = merge(merge(l, n), r);
+      }
+
+//---------------------------------------------------------
+//   eraseNode
+//    remove node n from tree t, returns the new tree
+//---------------------------------------------------------
+
+int SpannerMap::eraseNode(int t, int n) const
+      {
+      if (t == n)
+            return merge(nodes[n].left, nodes[n].right);
+      if (less(nodes[n], nodes[t]))
+            nodes[t].left = eraseNode(nodes[t].left, n);
+      else
+            nodes[t].right = eraseNode(nodes[t].right, n);
+      pull(t);
+      return t;
+      }
+
+//---------------------------------------------------------
+//   addNode
+//---------------------------------------------------------
+
+void SpannerMap::addNode(Spanner* s, int key) const
+      {
+      int n;
+      if (freeNodes.empty()) {
+            n = int(nodes.size());
+            nodes.emplace_back();
+            }
+      else {
+            n = freeNodes.back();
+            freeNodes.pop_back();
+            }
+      Node& node    = nodes[n];
+      node.start    = s->tick().ticks();
+      node.stop     = s->tick2().ticks();
+      node.seq      = nextSeq++;
+      // deterministic pseudo random priority, keeps the tree balanced
+      unsigned h    = node.seq * 2654435761u;
+      node.priority = h ^ (h >> 15);
+      node.key      = key;
+      node.spanner  = s;
+      auto i = index.find(s);
+      node.same = i == index.end() ? -1 : i->second;
+      index[s] = n;
+      insertNode(n);
+      }
+
+//---------------------------------------------------------
+//   clearTree
+//---------------------------------------------------------
+
+void SpannerMap::clearTree() const
+      {
+      nodes.clear();
+      freeNodes.clear();
+      index.clear();
+      root    = -1;
+      nextSeq = 0;
       }
 
 //---------------------------------------------------------
 //   update
-//   updates the internal lookup tree, not the map itself
+//   rebuilds the internal lookup tree, not the map itself
 //---------------------------------------------------------
 
 void SpannerMap::update() const
       {
-      std::vector< ::Interval<Spanner*> > intervals;
+      clearTree();
+      nodes.reserve(size());
       for (auto i : *this)
-            intervals.push_back(Interval<Spanner*>(i.second->tick().ticks(), i.second->tick2().ticks(), i.second));
-      tree = IntervalTree<Spanner*>(intervals);
+            addNode(i.second, i.first);
       dirty = false;
       }
 
@@ -43,12 +189,30 @@ void SpannerMap::update() const
 //   findContained
 //---------------------------------------------------------
 
-const std::vector<Interval<Spanner*>>& SpannerMap::findContained(int start, int stop)
+void SpannerMap::findContained(int t, int start, int stop, std::vector<Interval<Spanner*>>& results) const
       {
-      if (dirty)
-            update();
+      if (t == -1)
+            return;
+      const Node& node = nodes[t];
+      if (node.start >= start)
+            findContained(node.left, start, stop, results);
+      if (node.start >= start && node.start <= stop && node.stop <= stop)
+            results.push_back(Interval<Spanner*>(node.start, node.stop, node.spanner));
+      if (node.start <= stop)
+            findContained(node.right, start, stop, results);
+      }
+
+void SpannerMap::findContained(int start, int stop, std::vector<Interval<Spanner*>>& results) const
+      {
+      updateIfDirty();
       results.clear();
-      tree.findContained(start, stop, results);
+      findContained(root, start, stop, results);
+      }
+
+std::vector<Interval<Spanner*>> SpannerMap::findContained(int start, int stop) const
+      {
+      std::vector<Interval<Spanner*>> results;
+      findContained(start, stop, results);
       return results;
       }
 
@@ -56,12 +220,30 @@ const std::vector<Interval<Spanner*>>& SpannerMap::findContained(int start, int
 //   findOverlapping
 //---------------------------------------------------------
 
-const std::vector<Interval<Spanner*>>& SpannerMap::findOverlapping(int start, int stop)
+void SpannerMap::findOverlapping(int t, int start, int stop, std::vector<Interval<Spanner*>>& results) const
       {
-      if (dirty)
-            update();
+      if (t == -1 || nodes[t].maxStop < start)
+            return;
+      const Node& node = nodes[t];
+      findOverlapping(node.left, start, stop, results);
+      if (node.start <= stop) {
+            if (node.stop >= start)
+                  results.push_back(Interval<Spanner*>(node.start, node.stop, node.spanner));
+            findOverlapping(node.right, start, stop, results);
+            }
+      }
+
+void SpannerMap::findOverlapping(int start, int stop, std::vector<Interval<Spanner*>>& results) const
+      {
+      updateIfDirty();
       results.clear();
-      tree.findOverlapping(start, stop, results);
+      findOverlapping(root, start, stop, results);
+      }
+
+std::vector<Interval<Spanner*>> SpannerMap::findOverlapping(int start, int stop) const
+      {
+      std::vector<Interval<Spanner*>> results;
+      findOverlapping(start, stop, results);
       return results;
       }
 
@@ -81,8 +263,10 @@ void SpannerMap::addSpanner(Spanner* s)
             }
 #endif
 #endif
-      insert(std::pair<int,Spanner*>(s->tick().ticks(), s));
-      dirty = true;
+      const int key = s->tick().ticks();
+      insert(std::pair<int,Spanner*>(key, s));
+      if (!dirty)
+            addNode(s, key);
       }
 
 //---------------------------------------------------------
@@ -91,15 +275,49 @@ void SpannerMap::addSpanner(Spanner* s)
 
 bool SpannerMap::removeSpanner(Spanner* s)
       {
-      for (auto i = begin(); i != end(); ++i) {
+      updateIfDirty();
+      auto ii = index.find(s);
+      if (ii == index.end()) {
+            qDebug("%s (%p) not found", s->name(), s);
+            return false;
+            }
+      const int n = ii->second;
+      // the multimap key is the start tick when the spanner was added
+      auto range = equal_range(nodes[n].key);
+      for (auto i = range.first; i != range.second; ++i) {
             if (i->second == s) {
                   erase(i);
-                  dirty = true;
-                  return true;
+                  break;
                   }
             }
-      qDebug("%s (%p) not found", s->name(), s);
-      return false;
+      root = eraseNode(root, n);
+      if (nodes[n].same == -1)
+            index.erase(ii);
+      else
+            ii->second = nodes[n].same;
+      freeNodes.push_back(n);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   moveSpanner
+//    reposition s in the lookup tree after its start or
+//    length changed, if it is in the map
+//---------------------------------------------------------
+
+void SpannerMap::moveSpanner(Spanner* s)
+      {
+      if (dirty)
+            return;
+      auto ii = index.find(s);
+      if (ii == index.end())
+            return;
+      for (int n = ii->second; n != -1; n = nodes[n].same) {
+            root = eraseNode(root, n);
+            nodes[n].start = s->tick().ticks();
+            nodes[n].stop  = s->tick2().ticks();
+            insertNode(n);
+            }
       }
 
 #ifndef NDEBUG
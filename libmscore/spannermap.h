@@ -13,6 +13,7 @@
 #ifndef __SPANNERMAP_H__
 #define __SPANNERMAP_H__
 
+#include <unordered_map>
 
 #include "thirdparty/intervaltree/IntervalTree.h"
 
@@ -22,17 +23,57 @@ class Spanner;
 
 //---------------------------------------------------------
 //   SpannerMap
+//    The lookup tree is a treap ordered by start tick (and
+//    insertion order), each node knowing the largest stop
+//    tick below it. It is updated when spanners are added,
+//    removed or moved, queries are O(log n + results).
+//    The const queries do not modify the map and can run
+//    concurrently, as long as it is not dirty.
+//    findContained() and findOverlapping() return the
+//    spanners in start tick order, and in the order they
+//    were added for equal start ticks (the interval tree
+//    used before returned them in no defined order).
 //---------------------------------------------------------
 
 class SpannerMap : std::multimap<int, Spanner*> {
+      struct Node {
+            int start;
+            int stop;
+            int maxStop;            // largest stop in this subtree
+            unsigned seq;           // insertion order, orders equal start ticks
+            unsigned priority;
+            int left    { -1 };
+            int right   { -1 };
+            int same    { -1 };     // next node of the same spanner, if added twice
+            int key;                // key of the spanner in the multimap
+            Spanner* spanner;
+            };
+
       mutable bool dirty;
-      mutable IntervalTree<Spanner*> tree;
-      std::vector< ::Interval<Spanner*> > results;
+      mutable std::vector<Node> nodes;
+      mutable std::vector<int> freeNodes;
+      mutable std::unordered_map<Spanner*, int> index;
+      mutable int root;
+      mutable unsigned nextSeq;
+
+      bool less(const Node& a, const Node& b) const;
+      void pull(int n) const;
+      void split(int t, const Node& k, int* l, int* r) const;
+      int merge(int l, int r) const;
+      void insertNode(int n) const;
+      int eraseNode(int t, int n) const;
+      void addNode(Spanner* s, int key) const;
+      void clearTree() const;
+      void findContained(int t, int start, int stop, std::vector< ::Interval<Spanner*> >& results) const;
+      void findOverlapping(int t, int start, int stop, std::vector< ::Interval<Spanner*> >& results) const;
 
    public:
       SpannerMap();
-      const std::vector< ::Interval<Spanner*> >& findContained(int start, int stop);
-      const std::vector< ::Interval<Spanner*> >& findOverlapping(int start, int stop);
+      std::vector< ::Interval<Spanner*> > findContained(int start, int stop) const;
+      std::vector< ::Interval<Spanner*> > findOverlapping(int start, int stop) const;
+      // these fill a caller supplied buffer (cleared first), which can be reused
+      void findContained(int start, int stop, std::vector< ::Interval<Spanner*> >& results) const;
+      void findOverlapping(int start, int stop, std::vector< ::Interval<Spanner*> >& results) const;
       const std::multimap<int, Spanner*>& map() const { return *this; }
       std::multimap<int,Spanner*>::const_reverse_iterator crbegin() const { return std::multimap<int, Spanner*>::crbegin(); }
       std::multimap<int,Spanner*>::const_reverse_iterator crend() const   { return std::multimap<int, Spanner*>::crend(); }
@@ -40,9 +81,11 @@ class SpannerMap : std::multimap<int, Spanner*> {
       std::multimap<int,Spanner*>::const_iterator cend() const  { return std::multimap<int, Spanner*>::cend(); }
       void addSpanner(Spanner* s);
       bool removeSpanner(Spanner* s);
-      void clear() { std::multimap<int, Spanner*>::clear(); dirty = true; }
+      void moveSpanner(Spanner* s);             // must be called if a spanner changes start/length
+      void clear() { std::multimap<int, Spanner*>::clear(); clearTree(); dirty = false; }
       void update() const;
-      void setDirty() const { dirty = true; }   // must be called if a spanner changes start/length
+      void updateIfDirty() const { if (dirty) update(); }
+      void setDirty() const { dirty = true; }   // rebuilds the lookup tree on next use
 #ifndef NDEBUG
       void dump() const;
 #endif
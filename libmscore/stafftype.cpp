@@ -402,6 +402,7 @@ void StaffType::setDurationMetrics() const
       {
       if (_durationMetricsValid && _refDPI == DPI)           // metrics are still valid
             return;
+      MScore::loadFont(_durationFont.family());
 
 // QFontMetrics[F]() returns results unreliably rounded to integral pixels;
 // use a scaled up font and then scale computed values down
@@ -431,6 +432,7 @@ void StaffType::setFretMetrics() const
       {
       if (_fretMetricsValid && _refDPI == DPI)
             return;
+      MScore::loadFont(_fretFont.family());
 
       QFontMetricsF fm(fretFont(), MScore::paintDevice());
       QRectF bb;
@@ -1189,7 +1191,7 @@ bool StaffType::readConfigFile(const QString& fileName)
             path = rpath + QString("/fonts_tablature.xml");
             }
 #else
-            path = "/fonts/fonts_tablature.xml";
+            path = MS_DATA_PATH("/fonts/fonts_tablature.xml");
 #endif
             _durationFonts.clear();
             _fretFonts.clear();
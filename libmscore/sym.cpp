@@ -34,12 +34,12 @@ namespace Ms {
 static const int FALLBACK_FONT = 1;       // Bravura
 
 QVector<ScoreFont> ScoreFont::_scoreFonts {
-      ScoreFont("Leland",     "Leland",      "/fonts/leland/",    "Leland.woff2"   ),
-      ScoreFont("Bravura",    "Bravura",     "/fonts/bravura/",   "Bravura.woff2"  ),
-      ScoreFont("Emmentaler", "MScore",      "/fonts/mscore/",    "mscore.woff2"   ),
-      ScoreFont("Gonville",   "Gootville",   "/fonts/gootville/", "Gootville.woff2" ),
-      ScoreFont("MuseJazz",   "MuseJazz",     "/fonts/musejazz/", "MuseJazz.woff2" ),
-      ScoreFont("Petaluma",   "Petaluma",    "/fonts/petaluma/",  "Petaluma.woff2" ),
+      ScoreFont("Leland",     "Leland",      MS_DATA_PATH("/fonts/leland/"),    "Leland.woff2"   ),
+      ScoreFont("Bravura",    "Bravura",     MS_DATA_PATH("/fonts/bravura/"),   "Bravura.woff2"  ),
+      ScoreFont("Emmentaler", "MScore",      MS_DATA_PATH("/fonts/mscore/"),    "mscore.woff2"   ),
+      ScoreFont("Gonville",   "Gootville",   MS_DATA_PATH("/fonts/gootville/"), "Gootville.woff2" ),
+      ScoreFont("MuseJazz",   "MuseJazz",     MS_DATA_PATH("/fonts/musejazz/"), "MuseJazz.woff2" ),
+      ScoreFont("Petaluma",   "Petaluma",    MS_DATA_PATH("/fonts/petaluma/"),  "Petaluma.woff2" ),
       };
 
 std::array<uint, size_t(SymId::lastSym)+1> ScoreFont::_mainSymCodeTable { {0} };
@@ -6091,6 +6091,7 @@ Sym ScoreFont::sym(SymId id) const
     int index = static_cast<int>(id);
 
     if (index >= 0 && index < _symbols.size()) {
+        computePendingMetrics(index);
         return _symbols[index];
     }
 
@@ -6099,8 +6100,14 @@ Sym ScoreFont::sym(SymId id) const
 
 //---------------------------------------------------------
 //   draw
+//    the FreeType faces, the printing fonts and the glyph
+//    caches are shared, pages painted in parallel take turns
+//    (the glyph metrics must be computed before, see
+//    computeAllMetrics())
 //---------------------------------------------------------
 
+static QMutex drawMutex;
+
 void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos) const
       {
       qreal worldScale = painter->worldTransform().m11();
@@ -6131,13 +6138,9 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
                   qDebug("ScoreFont::draw: invalid sym %d", int(id));
             return;
             }
-      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
-      if (rv) {
-            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
-            return;
-            }
 
       if (MScore::pdfPrinting) {
+            QMutexLocker locker(&drawMutex);
             if (font == 0) {
                   QString s(_fontPath+_filename);
                   if (-1 == QFontDatabase::addApplicationFont(s)) {
@@ -6151,16 +6154,25 @@ void ScoreFont::draw(SymId id, QPainter* painter, const QSizeF& mag, const QPoin
                   font->setStyleStrategy(QFont::NoFontMerging);
                   font->setHintingPreference(QFont::PreferVerticalHinting);
                   }
+            QFont f(*font);
+            locker.unlock();
             qreal size = 20.0 * MScore::pixelRatio;
-            font->setPointSize(size);
+            f.setPointSize(size);
             QSizeF imag = QSizeF(1.0 / mag.width(), 1.0 / mag.height());
             painter->scale(mag.width(), mag.height());
-            painter->setFont(*font);
+            painter->setFont(f);
             painter->drawText(QPointF(pos.x() * imag.width(), pos.y() * imag.height()), toString(id));
             painter->scale(imag.width(), imag.height());
             return;
             }
 
+      QMutexLocker locker(&drawMutex);
+      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
+      if (rv) {
+            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
+            return;
+            }
+
       QColor color(painter->pen().color());
 
       int pr           = painter->device()->devicePixelRatio();
@@ -6332,7 +6344,7 @@ QString ScoreFont::toString(SymId id) const
 //   computeMetrics
 //---------------------------------------------------------
 
-void ScoreFont::computeMetrics(Sym* sym, int code)
+void ScoreFont::computeMetrics(Sym* sym, int code) const
       {
       FT_UInt index = FT_Get_Char_Index(face, code);
       if (index != 0) {
@@ -6355,12 +6367,46 @@ void ScoreFont::computeMetrics(Sym* sym, int code)
 //            qDebug("no index");
       }
 
+//---------------------------------------------------------
+//   computePendingMetrics
+//    the glyph metrics are computed on first use,
+//    loading a font does not go through all its glyphs
+//---------------------------------------------------------
+
+void ScoreFont::computePendingMetrics(int index) const
+      {
+      if (size_t(index) >= _pendingCodes.size() || _pendingCodes[index] == 0)
+            return;
+      const uint code = _pendingCodes[index];
+      _pendingCodes[index] = 0;
+      computeMetrics(&_symbols[index], code);
+      }
+
+//---------------------------------------------------------
+//   computeAllMetrics
+//    compute the pending glyph metrics of all loaded fonts,
+//    sym() then only reads them, and they can be used from
+//    several threads
+//---------------------------------------------------------
+
+void ScoreFont::computeAllMetrics()
+      {
+      for (const ScoreFont& sf : _scoreFonts) {
+            if (!sf.face)
+                  continue;
+            for (size_t i = 0; i < sf._pendingCodes.size(); ++i)
+                  sf.computePendingMetrics(int(i));
+            }
+      }
+
 //---------------------------------------------------------
 //   load
 //---------------------------------------------------------
 
 void ScoreFont::load()
       {
+      QElapsedTimer timer;
+      timer.start();
       QString facePath = _fontPath + _filename;
       QFile f(facePath);
       if (!f.open(QIODevice::ReadOnly)) {
@@ -6378,14 +6424,7 @@ void ScoreFont::load()
       qreal pixelSize = 200.0;
       FT_Set_Pixel_Sizes(face, 0, int(pixelSize+.5));
 
-      for (size_t id = 0; id < _mainSymCodeTable.size(); ++id) {
-            uint code = _mainSymCodeTable[id];
-            if (code == 0)
-                  continue;
-            SymId symId = SymId(id);
-            Sym* sym    = &_symbols[int(symId)];
-            computeMetrics(sym, code);
-            }
+      _pendingCodes.assign(_mainSymCodeTable.begin(), _mainSymCodeTable.end());
 
       QJsonParseError error;
       QFile fi(_fontPath + "metadata.json");
@@ -6561,6 +6600,7 @@ void ScoreFont::load()
             };
 
       for (const Composed& c : composed) {
+            computePendingMetrics(int(c.id));
             if (!_symbols[int(c.id)].isValid()) {
                   Sym* sym = &_symbols[int(c.id)];
                   std::vector<SymId> s;
@@ -6654,8 +6694,10 @@ void ScoreFont::load()
                         if (jo.value("name") == c.altKey) {
                               Sym* sym = &_symbols[int(c.id)];
                               int code = jo.value("codepoint").toString().midRef(2).toInt(&ok, 16);
-                              if (ok)
+                              if (ok) {
+                                    computePendingMetrics(int(c.id));
                                     computeMetrics(sym, code);
+                                    }
                               break;
                               }
                         }
@@ -6663,6 +6705,7 @@ void ScoreFont::load()
             }
 
       // add space symbol
+      computePendingMetrics(int(SymId::space));
       Sym* sym = &_symbols[int(SymId::space)];
       computeMetrics(sym, 32);
 
@@ -6680,6 +6723,9 @@ void ScoreFont::load()
                   }
             }
 #endif
+
+      if (MScore::debugMode)
+            qDebug("ScoreFont::load <%s>: %lld ms", qPrintable(_name), timer.elapsed());
       }
 
 //---------------------------------------------------------
@@ -6735,7 +6781,7 @@ const char* ScoreFont::fallbackTextFont()
 
 QJsonObject ScoreFont::initGlyphNamesJson()
       {
-      QFile fi("/fonts/smufl/glyphnames.json");
+      QFile fi(MS_DATA_PATH("/fonts/smufl/glyphnames.json"));
       if (!fi.open(QIODevice::ReadOnly)) {
             qDebug("ScoreFont: open glyph names file <%s> failed", qPrintable(fi.fileName()));
             return QJsonObject();
@@ -6872,6 +6918,9 @@ QPointF ScoreFont::cutOutSW(SymId id, qreal mag) const
 ScoreFont::ScoreFont(const ScoreFont& f)
       {
       face = 0;
+      // the copy has no face to compute the remaining metrics with
+      for (size_t i = 0; i < f._pendingCodes.size(); ++i)
+            f.computePendingMetrics(int(i));
       _symbols  = f._symbols;
       _name     = f._name;
       _family   = f._family;
@@ -3006,7 +3006,8 @@ inline uint qHash(const GlyphKey& k)
 
 class ScoreFont {
       FT_Face face = 0;
-      QVector<Sym> _symbols;
+      mutable QVector<Sym> _symbols;
+      mutable std::vector<uint> _pendingCodes;  // code of symbols whose metrics are not computed yet, or 0
       QString _name;
       QString _family;
       QString _fontPath;
@@ -3020,7 +3021,8 @@ class ScoreFont {
       static QVector<ScoreFont> _scoreFonts;
       static std::array<uint, size_t(SymId::lastSym)+1> _mainSymCodeTable;
       void load();
-      void computeMetrics(Sym* sym, int code);
+      void computeMetrics(Sym* sym, int code) const;
+      void computePendingMetrics(int index) const;
 
    public:
       ScoreFont() {}
@@ -3040,6 +3042,7 @@ class ScoreFont {
 
       static ScoreFont* fontFactory(QString);
       static ScoreFont* fallbackFont();
+      static void computeAllMetrics();
       static const char* fallbackTextFont();
       static const QVector<ScoreFont>& scoreFonts() { return _scoreFonts; }
       static QJsonObject initGlyphNamesJson();
@@ -245,8 +245,10 @@ void FSymbol::read(XmlReader& e)
       {
       while (e.readNextStartElement()) {
             const QStringRef& tag(e.name());
-            if (tag == "font")
+            if (tag == "font") {
                   _font.setFamily(e.readElementText());
+                  MScore::loadFont(_font.family());
+                  }
             else if (tag == "fontsize")
                   _font.setPointSizeF(e.readDouble());
             else if (tag == "code")
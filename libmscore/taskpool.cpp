@@ -0,0 +1,203 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2021 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "taskpool.h"
+
+#ifdef WEBMSCORE_THREADS
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#endif
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+TaskPool* TaskPool::instance()
+      {
+      static TaskPool pool;
+      return &pool;
+      }
+
+//---------------------------------------------------------
+//   ~TaskPool
+//---------------------------------------------------------
+
+TaskPool::~TaskPool()
+      {
+#ifdef WEBMSCORE_THREADS
+      stop();
+#endif
+      }
+
+//---------------------------------------------------------
+//   setThreads
+//    n <= 0: one thread per core. The calling thread
+//    counts as one, so n - 1 workers are started.
+//    Without WEBMSCORE_THREADS this is a no-op.
+//---------------------------------------------------------
+
+void TaskPool::setThreads(int n)
+      {
+#ifdef WEBMSCORE_THREADS
+      if (n <= 0)
+            n = std::max(1, int(std::thread::hardware_concurrency()));
+      if (n == _threads)
+            return;
+      stop();
+      _threads = n;
+      _stop = false;
+      for (int i = 1; i < n; ++i)
+            _workers.emplace_back(&TaskPool::work, this);
+#else
+      Q_UNUSED(n);
+#endif
+      }
+
+#ifdef WEBMSCORE_THREADS
+//---------------------------------------------------------
+//   stop
+//    finish the queued tasks and join the workers
+//---------------------------------------------------------
+
+void TaskPool::stop()
+      {
+      {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+      }
+      _cond.notify_all();
+      for (std::thread& t : _workers)
+            t.join();
+      _workers.clear();
+      _threads = 1;
+      }
+
+//---------------------------------------------------------
+//   work
+//---------------------------------------------------------
+
+void TaskPool::work()
+      {
+      for (;;) {
+            std::packaged_task<void()> task;
+            {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return _stop || !_tasks.empty(); });
+            if (_tasks.empty())
+                  return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            }
+            task();
+            }
+      }
+#endif
+
+//---------------------------------------------------------
+//   run
+//    run the task on a worker, or right away on the
+//    calling thread if there are none
+//---------------------------------------------------------
+
+std::future<void> TaskPool::run(std::function<void()> task)
+      {
+      std::packaged_task<void()> t(std::move(task));
+      std::future<void> f = t.get_future();
+#ifdef WEBMSCORE_THREADS
+      if (!_workers.empty()) {
+            {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(t));
+            }
+            _cond.notify_one();
+            return f;
+            }
+#endif
+      t();
+      return f;
+      }
+
+//---------------------------------------------------------
+//   parallelFor
+//    call fn(i) for i in [0, n), on the workers and the
+//    calling thread, and return when all calls are done.
+//    The caller takes indices too, and only waits for the
+//    calls that were started, so this does not deadlock
+//    when called from a task with all workers busy.
+//    If a call throws, the indices not started yet are
+//    skipped, and the first exception is rethrown to the
+//    caller once no call is running any more.
+//---------------------------------------------------------
+
+void TaskPool::parallelFor(int n, const std::function<void(int)>& fn)
+      {
+#ifdef WEBMSCORE_THREADS
+      const int helpers = std::min(_threads, n) - 1;
+      if (helpers > 0) {
+            // shared, as helpers may start after the caller returned
+            struct State {
+                  std::function<void(int)> fn;
+                  int n;
+                  std::atomic<int> next { 0 };
+                  std::atomic<bool> failed { false };
+                  int done { 0 };
+                  std::exception_ptr error;
+                  std::mutex mutex;
+                  std::condition_variable cond;
+                  };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            state->fn = fn;
+            state->n = n;
+            auto loop = [state]() {
+                  int count = 0;
+                  std::exception_ptr error;
+                  for (int i = state->next++; i < state->n; i = state->next++) {
+                        if (!state->failed) {
+                              try {
+                                    state->fn(i);
+                                    }
+                              catch (...) {
+                                    if (!error)
+                                          error = std::current_exception();
+                                    state->failed = true;
+                                    }
+                              }
+                        ++count;      // done, also when failed or skipped
+                        }
+                  if (count) {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (error && !state->error)
+                              state->error = error;
+                        state->done += count;
+                        if (state->done == state->n)
+                              state->cond.notify_all();
+                        }
+                  };
+            for (int i = 0; i < helpers; ++i)
+                  run(loop);
+            loop();
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cond.wait(lock, [&state] { return state->done == state->n; });
+            if (state->error)
+                  std::rethrow_exception(state->error);
+            return;
+            }
+#endif
+      for (int i = 0; i < n; ++i)
+            fn(i);
+      }
+
+}     // namespace Ms
@@ -0,0 +1,63 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2021 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TASKPOOL_H__
+#define __TASKPOOL_H__
+
+#include <functional>
+#include <future>
+
+#ifdef WEBMSCORE_THREADS
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   TaskPool
+//    a fixed number of worker threads shared by MIDI
+//    rendering and audio export, sized by setThreads().
+//    Without WEBMSCORE_THREADS (or with one thread) all
+//    tasks run on the calling thread.
+//---------------------------------------------------------
+
+class TaskPool {
+      int _threads { 1 };           // including the calling thread
+#ifdef WEBMSCORE_THREADS
+      std::vector<std::thread> _workers;
+      std::deque<std::packaged_task<void()>> _tasks;
+      std::mutex _mutex;
+      std::condition_variable _cond;
+      bool _stop { false };
+
+      void work();
+      void stop();
+#endif
+
+   public:
+      ~TaskPool();
+
+      static TaskPool* instance();
+
+      int threads() const { return _threads; }
+      void setThreads(int n);             // 0: one per core
+
+      std::future<void> run(std::function<void()> task);
+      void parallelFor(int n, const std::function<void(int)>& fn);
+      };
+
+}     // namespace Ms
+#endif
@@ -855,6 +855,7 @@ QFont TextFragment::font(const TextBase* t) const
             family = t->score()->styleSt(Sid::MusicalTextFont);
 
             // check if all symbols are available
+            MScore::loadFont(family);
             font.setFamily(family);
             QFontMetricsF fm(font);
 
@@ -885,6 +886,7 @@ QFont TextFragment::font(const TextBase* t) const
       else
             family = format.fontFamily();
 
+      MScore::loadFont(family);
       font.setFamily(family);
       font.setBold(format.bold());
       font.setItalic(format.italic());
@@ -2714,6 +2716,7 @@ QFont TextBase::font() const
       qreal m = _size;
       if (sizeIsSpatiumDependent())
             m *= spatium() / SPATIUM20;
+      MScore::loadFont(_family);
       QFont f(_family, m, bold() ? QFont::Bold : QFont::Normal, italic());
       if (underline())
             f.setUnderline(underline());
@@ -40,6 +40,65 @@ QRectF handleRect(const QPointF& pos)
       return QRectF(pos.x()-4, pos.y()-4, 8, 8);
       }
 
+//---------------------------------------------------------
+//   MeasureTickIndex::rebuild
+//---------------------------------------------------------
+
+void MeasureTickIndex::rebuild(Measure* first, bool mmRests)
+      {
+      _ticks.clear();
+      _measures.clear();
+      _sorted = true;
+      for (Measure* m = first; m; m = mmRests ? m->nextMeasureMM() : m->nextMeasure()) {
+            const Fraction tick = m->tick();
+            if (!_ticks.empty() && tick < _ticks.back())
+                  _sorted = false;
+            _ticks.push_back(tick);
+            _measures.push_back(m);
+            }
+      _first   = first;
+      _mmRests = mmRests;
+      _valid   = true;
+      }
+
+//---------------------------------------------------------
+//   MeasureTickIndex::find
+//    return the last measure starting at or before tick,
+//    nullptr if tick is not within the score
+//---------------------------------------------------------
+
+Measure* MeasureTickIndex::find(const Fraction& tick) const
+      {
+      const auto it = std::upper_bound(_ticks.begin(), _ticks.end(), tick);
+      if (it == _ticks.begin())
+            return 0;
+      const size_t idx = (it - _ticks.begin()) - 1;
+      Measure* m = _measures[idx];
+      // check last measure
+      if (idx + 1 == _measures.size() && tick > m->endTick())
+            return 0;
+      return m;
+      }
+
+//---------------------------------------------------------
+//   updateMeasureTickIndex
+//    rebuild the tick -> measure indices now, if needed.
+//    Until the score changes tick2measure() and
+//    tick2measureMM() then only read them, and can be called
+//    from several threads.
+//---------------------------------------------------------
+
+void Score::updateMeasureTickIndex() const
+      {
+      Measure* first = firstMeasure();
+      if (!_tickIndex.isValid(first, false))
+            _tickIndex.rebuild(first, false);
+      Measure* firstMM = firstMeasureMM();
+      const bool mmRests = styleB(Sid::createMultiMeasureRests);
+      if (!_tickIndexMM.isValid(firstMM, mmRests))
+            _tickIndexMM.rebuild(firstMM, mmRests);
+      }
+
 //---------------------------------------------------------
 //   tick2measure
 //---------------------------------------------------------
@@ -51,8 +110,19 @@ Measure* Score::tick2measure(const Fraction& tick) const
       if (tick <= Fraction(0,1))
             return firstMeasure();
 
+      Measure* first = firstMeasure();
+      if (!_tickIndex.isValid(first, false))
+            _tickIndex.rebuild(first, false);
+      if (_tickIndex.sorted()) {
+            Measure* m = _tickIndex.find(tick);
+            if (!m)
+                  qDebug("tick2measure %d (max %d) not found", tick.ticks(), lastMeasure() ? lastMeasure()->tick().ticks() : -1);
+            return m;
+            }
+
+      // ticks are not in order while the score is being modified
       Measure* lm = 0;
-      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+      for (Measure* m = first; m; m = m->nextMeasure()) {
             if (tick < m->tick()) {
                   Q_ASSERT(lm);
                   return lm;
@@ -78,9 +148,20 @@ Measure* Score::tick2measureMM(const Fraction& t) const
       if (tick < Fraction(0,1))
             tick = Fraction(0,1);
 
-      Measure* lm = 0;
+      Measure* first = firstMeasureMM();
+      const bool mmRests = styleB(Sid::createMultiMeasureRests);
+      if (!_tickIndexMM.isValid(first, mmRests))
+            _tickIndexMM.rebuild(first, mmRests);
+      if (_tickIndexMM.sorted()) {
+            Measure* m = _tickIndexMM.find(tick);
+            if (!m)
+                  qDebug("tick2measureMM %d (max %d) not found", tick.ticks(), lastMeasureMM() ? lastMeasureMM()->tick().ticks() : -1);
+            return m;
+            }
 
-      for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
+      // ticks are not in order while the score is being modified
+      Measure* lm = 0;
+      for (Measure* m = first; m; m = m->nextMeasureMM()) {
             if (tick < m->tick()) {
                   Q_ASSERT(lm);
                   return lm;
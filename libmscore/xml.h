@@ -241,6 +241,7 @@ class XmlWriter : public QTextStream {
       bool _recordElements = false;
 
       void putLevel();
+      void endLine();
 
    public:
       XmlWriter(Score*);
@@ -51,9 +51,25 @@ void XmlWriter::pTag(const char* name, PlaceText place)
 
 void XmlWriter::putLevel()
       {
-      int level = stack.size();
-      for (int i = 0; i < level * 2; ++i)
-            *this << ' ';
+      static const char spaces[] = "                                                                ";
+      const int maxSpaces = int(sizeof(spaces)) - 1;
+      for (int n = stack.size() * 2; n > 0; n -= maxSpaces)
+            *this << QLatin1String(spaces, qMin(n, maxSpaces));
+      }
+
+//---------------------------------------------------------
+//   endLine
+//    QTextStream::endl flushes the stream, which converts
+//    and writes the buffered text on every line. Only flush
+//    when the outermost tag is done, callers may read the
+//    device then.
+//---------------------------------------------------------
+
+void XmlWriter::endLine()
+      {
+      *this << '\n';
+      if (stack.isEmpty())
+            flush();
       }
 
 //---------------------------------------------------------
@@ -73,8 +89,9 @@ void XmlWriter::header()
 void XmlWriter::stag(const QString& s)
       {
       putLevel();
-      *this << '<' << s << '>' << endl;
-      stack.append(s.split(' ')[0]);
+      *this << '<' << s << '>';
+      endLine();
+      stack.append(s.left(s.indexOf(' ')));
       }
 
 //---------------------------------------------------------
@@ -98,7 +115,8 @@ void XmlWriter::stag(const QString& name, const ScoreElement* se, const QString&
       *this << '<' << name;
       if (!attributes.isEmpty())
             *this << ' ' << attributes;
-      *this << '>' << endl;
+      *this << '>';
+      endLine();
       stack.append(name);
 
       if (_recordElements)
@@ -113,7 +131,8 @@ void XmlWriter::stag(const QString& name, const ScoreElement* se, const QString&
 void XmlWriter::etag()
       {
       putLevel();
-      *this << "</" << stack.takeLast() << '>' << endl;
+      *this << "</" << stack.takeLast() << '>';
+      endLine();
       }
 
 //---------------------------------------------------------
@@ -131,7 +150,8 @@ void XmlWriter::tagE(const char* format, ...)
       vsnprintf(buffer, BS, format, args);
       *this << buffer;
       va_end(args);
-      *this << "/>" << endl;
+      *this << "/>";
+      endLine();
       }
 
 //---------------------------------------------------------
@@ -162,7 +182,8 @@ void XmlWriter::ntag(const char* name)
 
 void XmlWriter::netag(const char* s)
       {
-      *this << "</" << s << '>' << endl;
+      *this << "</" << s << '>';
+      endLine();
       }
 
 //---------------------------------------------------------
@@ -196,7 +217,7 @@ void XmlWriter::tag(const char* name, QVariant data, QVariant defaultData)
 
 void XmlWriter::tag(const QString& name, QVariant data)
       {
-      QString ename(name.split(' ')[0]);
+      QString ename(name.left(name.indexOf(' ')));
 
       putLevel();
       switch(data.type()) {
@@ -309,7 +330,8 @@ void XmlWriter::tag(const char* name, const QWidget* g)
 void XmlWriter::comment(const QString& text)
       {
       putLevel();
-      *this << "<!-- " << text << " -->" << endl;
+      *this << "<!-- " << text << " -->";
+      endLine();
       }
 
 //---------------------------------------------------------
@@ -341,11 +363,41 @@ QString XmlWriter::xmlString(ushort c)
 
 QString XmlWriter::xmlString(const QString& s)
       {
+      // most strings need no escaping, return them as they are
+      const int n = s.size();
+      int i = 0;
+      for (; i < n; ++i) {
+            ushort c = s.at(i).unicode();
+            if (c == '<' || c == '>' || c == '&' || c == '\"' || c < 0x20)
+                  break;
+            }
+      if (i == n)
+            return s;
+
       QString escaped;
-      escaped.reserve(s.size());
-      for (int i = 0; i < s.size(); ++i) {
+      escaped.reserve(n + 16);
+      escaped.append(s.constData(), i);
+      for (; i < n; ++i) {
             ushort c = s.at(i).unicode();
-            escaped += xmlString(c);
+            switch (c) {
+                  case '<':
+                        escaped += QLatin1String("&lt;");
+                        break;
+                  case '>':
+                        escaped += QLatin1String("&gt;");
+                        break;
+                  case '&':
+                        escaped += QLatin1String("&amp;");
+                        break;
+                  case '\"':
+                        escaped += QLatin1String("&quot;");
+                        break;
+                  default:
+                        // ignore invalid characters in xml 1.0
+                        if (c >= 0x20 || c == 0x09 || c == 0x0A || c == 0x0D)
+                              escaped += QChar(c);
+                        break;
+                  }
             }
       return escaped;
       }
@@ -384,7 +436,7 @@ void XmlWriter::dump(int len, const unsigned char* p)
 
 void XmlWriter::writeXml(const QString& name, QString s)
       {
-      QString ename(name.split(' ')[0]);
+      QString ename(name.left(name.indexOf(' ')));
       putLevel();
       for (int i = 0; i < s.size(); ++i) {
             ushort c = s.at(i).unicode();
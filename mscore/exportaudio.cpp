@@ -33,7 +33,10 @@
 #include "libmscore/note.h"
 #include "libmscore/part.h"
 #include "libmscore/mscore.h"
+#include "libmscore/repeatlist.h"
+#include "libmscore/taskpool.h"
 #include "audio/midi/msynthesizer.h"
+#include "audio/midi/simd.h"
 // #include "musescore.h"
 // #include "preferences.h"
 
@@ -47,6 +50,9 @@
 
 #include "libmscore/importexports.h"
 
+#include <QFileInfo>
+#include <QTemporaryFile>
+
 namespace Ms {
 
 MasterSynthesizer* synthesizerFactory() {
@@ -68,6 +74,26 @@ MasterSynthesizer* synthesizerFactory() {
         return ms;
 }
 
+//---------------------------------------------------------
+//   prefetchSamples
+//    load the samples of the score's instruments up front,
+//    SF3 samples are decoded in parallel
+//---------------------------------------------------------
+
+static void prefetchSamples(Score* score, MasterSynthesizer* synth)
+      {
+      FluidS::Fluid* fluid = static_cast<FluidS::Fluid*>(synth->synthesizer("Fluid"));
+      if (!fluid)
+            return;
+      std::vector<std::pair<int, int>> programs;
+      for (const MidiMapping& mm : score->masterScore()->midiMapping()) {
+            const Channel* c = mm.articulation();
+            if (c->synti() == "Fluid")
+                  programs.emplace_back(c->bank(), c->program());
+            }
+      fluid->prefetchPrograms(programs);
+      }
+
 static const unsigned SYNTH_FRAMES = 512;
 static const unsigned SYNTH_BUFFER_SIZE = sizeof(float) * SYNTH_FRAMES * 2;
 
@@ -76,15 +102,27 @@ static const unsigned SYNTH_BUFFER_SIZE = sizeof(float) * SYNTH_FRAMES * 2;
  * 
  * dest: [ channelA #len frames, channelB #len frames ]
  * 
- * TODO: use WebAssembly SIMD instructions 
- * https://v8.dev/features/simd
- * https://emscripten.org/docs/porting/simd.html
+ * WebAssembly SIMD (or SSE2) if enabled, see audio/midi/simd.h
  */
 void deinterleave(float* dest, const float* src, size_t framesLen) {
-      for (size_t i = 0, j = 0; i < framesLen; i++, j+=2) {
-            dest[i] = src[j];
-            dest[framesLen + i] = src[j+1];
-      }
+      Simd::deinterleave(dest, src, framesLen);
+}
+
+/**
+ * A playback event, with its time already converted to a frame offset
+ */
+struct SynthEvent {
+      int frame;
+      NPlayEvent event;
+};
+
+/**
+ * Interleave audio channels, the reverse of deinterleave
+ * 
+ * src: [ channelA #len frames, channelB #len frames ]
+ */
+void interleave(float* dest, const float* src, size_t framesLen) {
+      Simd::interleave(dest, src, framesLen);
 }
 
 std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime) {
@@ -105,36 +143,41 @@ std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime)
       }
 
       score->masterScore()->rebuildAndUpdateExpressive(synth->synthesizer("Fluid"));
+      prefetchSamples(score, synth);
       score->renderMidi(&events, score->synthesizerState());
       if (events.empty()) {
             return nullptr;
       }
 
-      EventMap::const_iterator endPos = events.cend();
-      --endPos;
-      const int et = (score->utick2utime(endPos->first) + 1) * MScore::sampleRate;
-
-      EventMap::const_iterator playPos;
-      playPos = events.cbegin();
-      synth->allSoundsOff(-1);
-
       // 
-      // seek
+      // flatten the events, and convert their ticks to frame offsets once,
+      // so that every chunk only visits its own events
       // 
-      int posIndex = 0;
-      for (;;) {
-            if (playPos == events.cend()) {  // starttime is greater than the max duration
-                  return nullptr;
-            }
-            float t = score->utick2utime(playPos->first);
-            if (t >= starttime - 0.0005) {  // round to the nearest thousandth
+      auto synthEvents = std::make_shared<std::vector<SynthEvent>>();
+      synthEvents->reserve(events.size());
+      TimeCursor timeCursor(score->repeatList());  // events are visited in order
+      qreal endt = 0;
+      size_t posIndex = 0;
+      bool found = false;
+      for (const auto& ev : events) {
+            endt = timeCursor.utick2utime(ev.first);
+            float t = endt;
+            // seek
+            if (!found && t >= starttime - 0.0005) {  // round to the nearest thousandth
                   starttime = t;
-                  break;
+                  posIndex = synthEvents->size();
+                  found = true;
             }
-            ++posIndex;
-            ++playPos;
+            synthEvents->push_back({ int(endt * MScore::sampleRate), ev.second });
       }
+      if (!found) {  // starttime is greater than the max duration
+            return nullptr;
+      }
+      events.clear();
+
+      const int et = (endt + 1) * MScore::sampleRate;
       int playTime = starttime * MScore::sampleRate;
+      synth->allSoundsOff(-1);
 
       //
       // init instruments
@@ -159,18 +202,17 @@ std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime)
 
       auto synthIterator = [=](bool cancel = false) mutable -> SynthRes* { 
             if (done) {
-                  return new SynthRes{done, -1, -1, 0};
+                  // malloc'ed like the other results, the caller frees them all with free()
+                  auto res = (SynthRes*)calloc(1, sizeof(SynthRes));
+                  res->done = done;
+                  res->startTime = -1;
+                  res->endTime = -1;
+                  return res;
             }
 
             auto res = (SynthRes*)calloc(1, sizeof(SynthRes) + SYNTH_BUFFER_SIZE); 
             res->chunkSize = SYNTH_BUFFER_SIZE;
 
-            // re-seek
-            playPos = events.cbegin();
-            for (int i = 0; i < posIndex; i++) {
-                  ++playPos;
-            }
-
             unsigned frames = SYNTH_FRAMES;
             //
             // collect events for one segment
@@ -181,8 +223,9 @@ std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime)
             float buffer[SYNTH_FRAMES * 2] = {};
             float* p = buffer;
 
-            for (; playPos != events.cend(); ++playPos, ++posIndex) {
-                  int f = score->utick2utime(playPos->first) * MScore::sampleRate;
+            for (; posIndex < synthEvents->size(); ++posIndex) {
+                  const SynthEvent& se = (*synthEvents)[posIndex];
+                  int f = se.frame;
                   if (f >= endTime)
                         break;
 
@@ -194,7 +237,7 @@ std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime)
 
                   playTime  += n;
                   frames    -= n;
-                  const NPlayEvent& e = playPos->second;
+                  const NPlayEvent& e = se.event;
                   if (e.isChannelEvent()) {
                         int channelIdx = e.channel();
                         const Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation();
@@ -230,15 +273,100 @@ std::function<SynthRes*(bool)> synthAudioWorklet(Score* score, float starttime)
       return synthIterator;
 }
 
+//---------------------------------------------------------
+//   PcmBuffer
+//    holds the synthesized (interleaved float) samples
+//    until the peak of the whole song is known,
+//    spills to a temporary file when it grows too large
+//---------------------------------------------------------
+
+class PcmBuffer {
+      static const int MAX_MEMORY = 32 * 1024 * 1024;  // bytes, ~95 seconds of stereo at 44.1 kHz
+      static const int CHUNK_SAMPLES = 16 * 1024;
+
+      QByteArray _mem;
+      QTemporaryFile _file;
+      bool _spilled = false;
+      std::vector<float> _chunk;    // replay buffer, on the heap (small wasm stack)
+
+   public:
+      bool write(const float* data, int samples);
+      bool replay(QIODevice* device, float gain);
+      };
+
+//---------------------------------------------------------
+//   write
+//---------------------------------------------------------
+
+bool PcmBuffer::write(const float* data, int samples)
+      {
+      const int len = samples * int(sizeof(float));
+      if (!_spilled && _mem.size() + len > MAX_MEMORY) {
+            if (!_file.open()) {
+                  qDebug("PcmBuffer: cannot open temporary file");
+                  return false;
+                  }
+            _file.write(_mem);
+            _mem.clear();
+            _mem.squeeze();
+            _spilled = true;
+            }
+      if (_spilled)
+            return _file.write(reinterpret_cast<const char*>(data), len) == len;
+      _mem.append(reinterpret_cast<const char*>(data), len);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   replay
+//    write the buffered samples to device, scaled by gain
+//---------------------------------------------------------
+
+bool PcmBuffer::replay(QIODevice* device, float gain)
+      {
+      _chunk.resize(CHUNK_SAMPLES);
+      float* buffer = _chunk.data();
+      const qint64 chunkLen = CHUNK_SAMPLES * sizeof(float);
+
+      if (_spilled) {
+            if (!_file.seek(0))
+                  return false;
+            }
+      const char* src = _mem.constData();
+      qint64 remaining = _spilled ? _file.size() : _mem.size();
+
+      while (remaining > 0) {
+            qint64 len = qMin(remaining, chunkLen);
+            if (_spilled) {
+                  if (_file.read(reinterpret_cast<char*>(buffer), len) != len)
+                        return false;
+                  }
+            else {
+                  memcpy(buffer, src, len);
+                  src += len;
+                  }
+            const int n = len / sizeof(float);
+            for (int i = 0; i < n; ++i)
+                  buffer[i] *= gain;
+            device->write(reinterpret_cast<const char*>(buffer), len);
+            remaining -= len;
+            }
+      return true;
+      }
+
 ///
 /// \brief Function to synthesize audio and output it into a generic QIODevice
 /// \param score The score to output
 /// \param device The output device
 /// \param updateProgress An optional callback function that will be notified with the progress in range [0, 1], and the current play time in seconds
 /// \param starttime The start time offset in seconds
-/// \param audioNormalize Process the audio twice
+/// \param audioNormalize Scale the output so that its peak is just below full scale
 /// \return True on success, false otherwise.
 ///
+/// The score is rendered and synthesized only once.
+/// With audioNormalize, the samples are buffered until the end of the song, then written scaled by the gain.
+/// Otherwise, with worker threads (TaskPool), the samples are written in batches on a worker,
+/// so encoding one batch overlaps synthesizing the next.
 /// If the callback function is non zero an returns false the export will be canceled.
 ///
 bool saveAudio(Score* score, QIODevice *device, std::function<bool(float, float)> updateProgress, float starttime, bool audioNormalize)
@@ -256,19 +384,6 @@ bool saveAudio(Score* score, QIODevice *device, std::function<bool(float, float)
             }
 
       EventMap events;
-      // In non-GUI mode current synthesizer settings won't
-      // allow single note dynamics. See issue #289947.
-      const bool useCurrentSynthesizerState = !MScore::noGui;
-
-#if 0
-      if (useCurrentSynthesizerState) {
-            score->renderMidi(&events, synthesizerState());
-            if (events.empty()) {
-                  device->close();
-                  return false;
-                  }
-            }
-#endif
 
       MasterSynthesizer* synth = synthesizerFactory();
       synth->init();
@@ -283,21 +398,19 @@ bool saveAudio(Score* score, QIODevice *device, std::function<bool(float, float)
       if (!setStateOk || !synth->hasSoundFontsLoaded())
             synth->init(); // re-initialize master synthesizer with default settings
 
-      if (!useCurrentSynthesizerState) {
-            score->masterScore()->rebuildAndUpdateExpressive(synth->synthesizer("Fluid"));
-            score->renderMidi(&events, score->synthesizerState());
-            // if (synti)
-            //       score->masterScore()->rebuildAndUpdateExpressive(synti->synthesizer("Fluid"));
-
-            if (events.empty())
-                  return false;
+      score->masterScore()->rebuildAndUpdateExpressive(synth->synthesizer("Fluid"));
+      prefetchSamples(score, synth);
+      score->renderMidi(&events, score->synthesizerState());
+      if (events.empty()) {
+            delete synth;
+            device->close();
+            return false;
             }
 
       int oldSampleRate  = MScore::sampleRate;
       MScore::sampleRate = sampleRate;
 
       float peak  = 0.0;
-      double gain = 1.0;
       EventMap::const_iterator endPos = events.cend();
       --endPos;
       const qreal _endt = score->utick2utime(endPos->first); // in seconds
@@ -305,219 +418,367 @@ bool saveAudio(Score* score, QIODevice *device, std::function<bool(float, float)
       const int maxEndTime = (_endt + 3) * MScore::sampleRate;
 
       bool cancelled = false;
-      //     int passes = preferences.getBool(PREF_EXPORT_AUDIO_NORMALIZE) ? 2 : 1;
-      int passes = audioNormalize ? 2 : 1;
-      for (int pass = 0; pass < passes; ++pass) {
-            EventMap::const_iterator playPos;
-            playPos = events.cbegin();
-            synth->allSoundsOff(-1);
+      bool ok = true;
+      PcmBuffer pcm;
 
-            // seek
-            for (;;) {
-                  if (playPos == events.cend()) {  // starttime is greater than the max duration
-                        return false;
+      EventMap::const_iterator playPos;
+      playPos = events.cbegin();
+      synth->allSoundsOff(-1);
+      TimeCursor timeCursor(score->repeatList());
+
+      // seek
+      for (;;) {
+            if (playPos == events.cend()) {  // starttime is greater than the max duration
+                  MScore::sampleRate = oldSampleRate;
+                  delete synth;
+                  device->close();
+                  return false;
                   }
-                  float t = score->utick2utime(playPos->first);
-                  if (t >= starttime - 0.0005) {  // round to the nearest thousandth
-                        starttime = t;
-                        break;
+            float t = timeCursor.utick2utime(playPos->first);
+            if (t >= starttime - 0.0005) {  // round to the nearest thousandth
+                  starttime = t;
+                  break;
                   }
-                  ++playPos;
+            ++playPos;
             }
 
-            //
-            // init instruments
-            //
-            for (Part* part : score->parts()) {
-                  const InstrumentList* il = part->instruments();
-                  for (auto i = il->begin(); i!= il->end(); i++) {
-                        for (const Channel* instrChan : i->second->channel()) {
-                              const Channel* a = score->masterScore()->playbackChannel(instrChan);
-                              for (MidiCoreEvent e : a->initList()) {
-                                    if (e.type() == ME_INVALID)
-                                          continue;
-                                    e.setChannel(a->channel());
-                                    int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel())->articulation()->synti());
-                                    synth->play(e, syntiIdx);
-                                    }
+      //
+      // init instruments
+      //
+      for (Part* part : score->parts()) {
+            const InstrumentList* il = part->instruments();
+            for (auto i = il->begin(); i!= il->end(); i++) {
+                  for (const Channel* instrChan : i->second->channel()) {
+                        const Channel* a = score->masterScore()->playbackChannel(instrChan);
+                        for (MidiCoreEvent e : a->initList()) {
+                              if (e.type() == ME_INVALID)
+                                    continue;
+                              e.setChannel(a->channel());
+                              int syntiIdx = synth->index(score->masterScore()->midiMapping(a->channel())->articulation()->synti());
+                              synth->play(e, syntiIdx);
                               }
                         }
                   }
+            }
 
-            static const unsigned FRAMES = 512;
-            float buffer[FRAMES * 2];
-            //     int playTime = 0;
-            int playTime = starttime * MScore::sampleRate;
-
-            for (;;) {
-                  unsigned frames = FRAMES;
-                  //
-                  // collect events for one segment
-                  //
-                  float max = 0.0;
-                  memset(buffer, 0, sizeof(float) * FRAMES * 2);
-                  int endTime = playTime + frames;
-                  float* p = buffer;
-                  for (; playPos != events.cend(); ++playPos) {
-                        int f = score->utick2utime(playPos->first) * MScore::sampleRate;
-                        if (f >= endTime)
-                              break;
-                        int n = f - playTime;
-                        if (n) {
-                              synth->process(n, p);
-                              p += 2 * n;
-                              }
+      static const unsigned FRAMES = 512;
+      float buffer[FRAMES * 2];
+
+      static const int ENCODE_BATCH = 64 * sizeof(buffer);   // bytes, ~0.75 seconds
+      TaskPool* pool = TaskPool::instance();
+      const bool encodeAsync = !audioNormalize && pool->threads() > 1;
+      QByteArray batch;
+      std::future<void> encoding;
+      auto encodeBatch = [&]() {
+            if (encoding.valid())
+                  encoding.wait();      // the device is written by one batch at a time, in order
+            QByteArray data;
+            data.swap(batch);
+            encoding = pool->run([device, data]() { device->write(data); });
+            };
 
-                        playTime  += n;
-                        frames    -= n;
-                        const NPlayEvent& e = playPos->second;
-                        if (!(!e.velo() && e.discard()) && e.isChannelEvent()) {
-                              int channelIdx = e.channel();
-                              const Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation();
-                              if (!c->mute()) {
-                                    synth->play(e, synth->index(c->synti()));
-                                    }
-                              }
-                        }
-                  if (frames) {
-                        synth->process(frames, p);
-                        playTime += frames;
-                        }
-                  if (pass == 1) {
-                        for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                              max = qMax(max, qAbs(buffer[i]));
-                              buffer[i] *= gain;
-                              }
-                        }
-                  else {
-                        for (unsigned i = 0; i < FRAMES * 2; ++i) {
-                              max = qMax(max, qAbs(buffer[i]));
-                              peak = qMax(peak, qAbs(buffer[i]));
-                              }
+      //     int playTime = 0;
+      int playTime = starttime * MScore::sampleRate;
+
+      for (;;) {
+            unsigned frames = FRAMES;
+            //
+            // collect events for one segment
+            //
+            float max = 0.0;
+            memset(buffer, 0, sizeof(float) * FRAMES * 2);
+            int endTime = playTime + frames;
+            float* p = buffer;
+            for (; playPos != events.cend(); ++playPos) {
+                  int f = timeCursor.utick2utime(playPos->first) * MScore::sampleRate;
+                  if (f >= endTime)
+                        break;
+                  int n = f - playTime;
+                  if (n) {
+                        synth->process(n, p);
+                        p += 2 * n;
                         }
-                  if (pass == (passes - 1))
-                        device->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
-                  playTime = endTime;
-                  if (updateProgress) {
-                        // normalize to [0, 1] range
-                        if (!updateProgress(float(pass * et + playTime) / passes / et, float(playTime) / MScore::sampleRate)) {
-                              cancelled = true;
-                              break;
+
+                  playTime  += n;
+                  frames    -= n;
+                  const NPlayEvent& e = playPos->second;
+                  if (!(!e.velo() && e.discard()) && e.isChannelEvent()) {
+                        int channelIdx = e.channel();
+                        const Channel* c = score->masterScore()->midiMapping(channelIdx)->articulation();
+                        if (!c->mute()) {
+                              synth->play(e, synth->index(c->synti()));
                               }
                         }
-                  if (playTime >= et)
-                        synth->allNotesOff(-1);
-                  // create sound until the sound decays
-                  if (playTime >= et && max*peak < 0.000001)
+                  }
+            if (frames) {
+                  synth->process(frames, p);
+                  playTime += frames;
+                  }
+            for (unsigned i = 0; i < FRAMES * 2; ++i)
+                  max = qMax(max, qAbs(buffer[i]));
+            peak = qMax(peak, max);
+            if (audioNormalize) {
+                  if (!pcm.write(buffer, FRAMES * 2)) {
+                        ok = false;
                         break;
-                  // hard limit
-                  if (playTime > maxEndTime)
+                        }
+                  }
+            else if (encodeAsync) {
+                  batch.append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+                  if (batch.size() >= ENCODE_BATCH)
+                        encodeBatch();
+                  }
+            else
+                  device->write(reinterpret_cast<const char*>(buffer), 2 * FRAMES * sizeof(float));
+            playTime = endTime;
+            if (updateProgress) {
+                  // normalize to [0, 1] range
+                  if (!updateProgress(float(playTime) / et, float(playTime) / MScore::sampleRate)) {
+                        cancelled = true;
                         break;
+                        }
                   }
-            if (cancelled)
+            if (playTime >= et)
+                  synth->allNotesOff(-1);
+            // create sound until the sound decays
+            if (playTime >= et && max*peak < 0.000001)
                   break;
-            if (pass == 0 && peak == 0.0) {
-                  qDebug("song is empty");
+            // hard limit
+            if (playTime > maxEndTime)
                   break;
-                  }
-            gain = 0.99 / peak;
             }
 
+      if (!batch.isEmpty())
+            encodeBatch();
+      if (encoding.valid())
+            encoding.wait();
+
       MScore::sampleRate = oldSampleRate;
       delete synth;
 
+      if (audioNormalize && ok && !cancelled) {
+            if (peak == 0.0)
+                  qDebug("song is empty");
+            // the synthesizer is not run again, only the samples are scaled
+            const float gain = peak == 0.0 ? 1.0 : 0.99 / peak;
+            ok = pcm.replay(device, gain);
+            }
+
       device->close();
 
-      return !cancelled;
+      return ok && !cancelled;
       }
 
 #ifdef HAS_AUDIOFILE
 
+//---------------------------------------------------------
+//   AudioSink
+//    growable memory sink for the libsndfile virtual I/O,
+//    the bytes before _offset have already been taken out
+//---------------------------------------------------------
+
+class AudioSink {
+      QByteArray _data;        // bytes not taken out yet
+      sf_count_t _offset = 0;  // stream position of _data[0]
+      sf_count_t _pos = 0;     // stream position of the next read/write
+
+      static sf_count_t vioGetFilelen(void* user);
+      static sf_count_t vioSeek(sf_count_t offset, int whence, void* user);
+      static sf_count_t vioRead(void* ptr, sf_count_t count, void* user);
+      static sf_count_t vioWrite(const void* ptr, sf_count_t count, void* user);
+      static sf_count_t vioTell(void* user);
+
+   public:
+      static SF_VIRTUAL_IO vio;
+
+      QByteArray take();
+      };
+
+SF_VIRTUAL_IO AudioSink::vio = {
+      AudioSink::vioGetFilelen,
+      AudioSink::vioSeek,
+      AudioSink::vioRead,
+      AudioSink::vioWrite,
+      AudioSink::vioTell
+      };
+
+sf_count_t AudioSink::vioGetFilelen(void* user)
+      {
+      AudioSink* s = static_cast<AudioSink*>(user);
+      return s->_offset + s->_data.size();
+      }
 
 //---------------------------------------------------------
-//   saveAudio
+//   vioSeek
+//    the data already taken out cannot be sought to,
+//    encoders that patch their header on close (wav, flac)
+//    must not be taken out before they are closed
 //---------------------------------------------------------
 
-bool saveAudio(Score* score, const QString& name)
+sf_count_t AudioSink::vioSeek(sf_count_t offset, int whence, void* user)
       {
-      // QIODevice - SoundFile wrapper class
-      class SoundFileDevice : public QIODevice {
-      private:
-            SF_INFO info;
-            SNDFILE *sf = nullptr;
-            const QString filename;
-      public:
-            SoundFileDevice(int sampleRate, int format, const QString& name)
-                  : filename(name) {
-                  memset(&info, 0, sizeof(info));
-                  info.channels   = 2;
-                  info.samplerate = sampleRate;
-                  info.format     = format;
-                  }
-            ~SoundFileDevice() {
-                  if (sf) {
-                        sf_close(sf);
-                        sf = nullptr;
-                        }
-                  }
+      AudioSink* s = static_cast<AudioSink*>(user);
+      const sf_count_t len = s->_offset + s->_data.size();
+      sf_count_t pos;
+      switch (whence) {
+            case SEEK_SET: pos = offset; break;
+            case SEEK_CUR: pos = s->_pos + offset; break;
+            case SEEK_END: pos = len + offset; break;
+            default:       return -1;
+            }
+      if (pos < s->_offset || pos > len) {
+            qDebug("AudioSink: cannot seek to %lld", (long long)pos);
+            return -1;
+            }
+      s->_pos = pos;
+      return pos;
+      }
 
-            virtual qint64 readData(char *dta, qint64 maxlen) override final {
-                  Q_UNUSED(dta);
-                  qDebug() << "Error: No write supported!";
-                  return maxlen;
-                  }
+sf_count_t AudioSink::vioRead(void* ptr, sf_count_t count, void* user)
+      {
+      AudioSink* s = static_cast<AudioSink*>(user);
+      const sf_count_t len = s->_offset + s->_data.size();
+      const sf_count_t n = qMin(count, len - s->_pos);
+      if (n <= 0)
+            return 0;
+      memcpy(ptr, s->_data.constData() + (s->_pos - s->_offset), n);
+      s->_pos += n;
+      return n;
+      }
+
+sf_count_t AudioSink::vioWrite(const void* ptr, sf_count_t count, void* user)
+      {
+      AudioSink* s = static_cast<AudioSink*>(user);
+      const int idx = s->_pos - s->_offset;
+      if (idx + count > s->_data.size())
+            s->_data.resize(idx + count);
+      memcpy(s->_data.data() + idx, ptr, count);
+      s->_pos += count;
+      return count;
+      }
+
+sf_count_t AudioSink::vioTell(void* user)
+      {
+      return static_cast<AudioSink*>(user)->_pos;
+      }
+
+//---------------------------------------------------------
+//   take
+//    hand out the bytes written so far
+//---------------------------------------------------------
 
-            virtual qint64 writeData(const char *dta, qint64 len) override final {
-                  size_t trueFrames = len / sizeof(float) / 2;
-                  sf_writef_float(sf, reinterpret_cast<const float*>(dta), trueFrames);
-                  return trueFrames * 2 * sizeof(float);
+QByteArray AudioSink::take()
+      {
+      QByteArray data;
+      data.swap(_data);
+      _offset += data.size();
+      return data;
+      }
+
+//---------------------------------------------------------
+//   SoundFileDevice
+//    QIODevice - SoundFile wrapper class,
+//    writes to a file, or to an AudioSink in memory
+//---------------------------------------------------------
+
+class SoundFileDevice : public QIODevice {
+   private:
+      SF_INFO info;
+      SNDFILE *sf = nullptr;
+      const QString filename;
+      AudioSink* sink = nullptr;
+   public:
+      SoundFileDevice(int sampleRate, int format, const QString& name)
+            : filename(name) {
+            memset(&info, 0, sizeof(info));
+            info.channels   = 2;
+            info.samplerate = sampleRate;
+            info.format     = format;
+            }
+      SoundFileDevice(int sampleRate, int format, AudioSink* s)
+            : sink(s) {
+            memset(&info, 0, sizeof(info));
+            info.channels   = 2;
+            info.samplerate = sampleRate;
+            info.format     = format;
+            }
+      ~SoundFileDevice() {
+            if (sf) {
+                  sf_close(sf);
+                  sf = nullptr;
                   }
+            }
 
-            bool open(QIODevice::OpenMode mode) {
-                  if ((mode & QIODevice::WriteOnly) == 0) {
-                        return false;
-                        }
+      virtual qint64 readData(char *dta, qint64 maxlen) override final {
+            Q_UNUSED(dta);
+            qDebug() << "Error: No write supported!";
+            return maxlen;
+            }
+
+      virtual qint64 writeData(const char *dta, qint64 len) override final {
+            size_t trueFrames = len / sizeof(float) / 2;
+            sf_writef_float(sf, reinterpret_cast<const float*>(dta), trueFrames);
+            return trueFrames * 2 * sizeof(float);
+            }
+
+      bool open(QIODevice::OpenMode mode) {
+            if ((mode & QIODevice::WriteOnly) == 0) {
+                  return false;
+                  }
 
+            if (sink) {
+                  sf = sf_open_virtual(&AudioSink::vio, SFM_WRITE, &info, sink);
+                  }
+            else {
 #ifdef Q_OS_WIN
-                  #define SF_FILENAME_LEN	1024
-                  QByteArray path = filename.toUtf8();
-                  wchar_t wpath[SF_FILENAME_LEN];
-                  int dwRet = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path.constData(), -1, wpath, SF_FILENAME_LEN);
-                  if (dwRet == 0) {
-                        qCritical() << Q_FUNC_INFO << "filed get path: " << GetLastError() << "\n";  
-                        return false; 
-                        }
-                  sf = sf_wchar_open(wpath, SFM_WRITE, &info);
+            #define SF_FILENAME_LEN	1024
+            QByteArray path = filename.toUtf8();
+            wchar_t wpath[SF_FILENAME_LEN];
+            int dwRet = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path.constData(), -1, wpath, SF_FILENAME_LEN);
+            if (dwRet == 0) {
+                  qCritical() << Q_FUNC_INFO << "filed get path: " << GetLastError() << "\n";  
+                  return false; 
+                  }
+            sf = sf_wchar_open(wpath, SFM_WRITE, &info);
 #else  // Q_OS_WIN
-                  sf = sf_open(qPrintable(filename), SFM_WRITE, &info);
+            sf = sf_open(qPrintable(filename), SFM_WRITE, &info);
 #endif // Q_OS_WIN
+                  }
 
-                  if (sf == nullptr) {
-                        qDebug("open soundfile failed: %s", sf_strerror(sf));
-                        return false;
-                        }
-                  
-                  // if ((info.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_MP3) {
-                  //       // set the bitrate to 320kbps
-                  //       // bitrate = (320.0 - (compression * (320.0 - 32.0)))
-                  //       auto mode = SF_BITRATE_MODE_CONSTANT;
-                  //       sf_command(sf, SFC_SET_BITRATE_MODE, &mode, sizeof(int));
-                  //       double compression = 0;
-                  //       sf_command(sf, SFC_SET_COMPRESSION_LEVEL, &compression, sizeof(double));
-                  // }
-
-                  return QIODevice::open(mode);
+            if (sf == nullptr) {
+                  qDebug("open soundfile failed: %s", sf_strerror(sf));
+                  return false;
                   }
-            void close() {
-                  if (sf && sf_close(sf)) {
-                        qDebug("close soundfile failed");
-                        }
-     
-                  sf = nullptr;
-                  QIODevice::close();
+            
+            // if ((info.format & SF_FORMAT_TYPEMASK) == SF_FORMAT_MP3) {
+            //       // set the bitrate to 320kbps
+            //       // bitrate = (320.0 - (compression * (320.0 - 32.0)))
+            //       auto mode = SF_BITRATE_MODE_CONSTANT;
+            //       sf_command(sf, SFC_SET_BITRATE_MODE, &mode, sizeof(int));
+            //       double compression = 0;
+            //       sf_command(sf, SFC_SET_COMPRESSION_LEVEL, &compression, sizeof(double));
+            // }
+
+            return QIODevice::open(mode);
+            }
+      void close() {
+            if (sf && sf_close(sf)) {
+                  qDebug("close soundfile failed");
                   }
-            };
-      int format;
+
+            sf = nullptr;
+            QIODevice::close();
+            }
+      };
+
+//---------------------------------------------------------
+//   audioFileFormat
+//    libsndfile format for the file extension,
+//    0 if unknown
+//---------------------------------------------------------
+
+static int audioFileFormat(const QString& ext)
+      {
       // int PCMRate;
       // switch (preferences.getInt(PREF_EXPORT_AUDIO_PCMRATE)) {
       //       case 32: PCMRate = SF_FORMAT_PCM_32; break;
@@ -527,39 +788,33 @@ bool saveAudio(Score* score, const QString& name)
       //       default: PCMRate = SF_FORMAT_PCM_16; break;
       //       }
 
-      if (name.endsWith(".wav"))
-            format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
-      else if (name.endsWith(".pcm"))
-            format = SF_FORMAT_RAW | SF_FORMAT_FLOAT;
-      else if (name.endsWith(".ogg"))
-            format = SF_FORMAT_OGG | SF_FORMAT_VORBIS;
-      else if (name.endsWith(".flac"))
-            format = SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
-      else if (name.endsWith(".mp3"))
-            format = SF_FORMAT_MP3 | SF_FORMAT_MPEG_LAYER_III;
-      else {
+      if (ext == "wav")
+            return SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+      else if (ext == "pcm")
+            return SF_FORMAT_RAW | SF_FORMAT_FLOAT;
+      else if (ext == "ogg")
+            return SF_FORMAT_OGG | SF_FORMAT_VORBIS;
+      else if (ext == "flac")
+            return SF_FORMAT_FLAC | SF_FORMAT_PCM_16;
+      else if (ext == "mp3")
+            return SF_FORMAT_MP3 | SF_FORMAT_MPEG_LAYER_III;
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   saveAudio
+//---------------------------------------------------------
+
+bool saveAudio(Score* score, const QString& name)
+      {
+      int format = audioFileFormat(QFileInfo(name).suffix());
+      if (!format) {
             qDebug("unknown audio file type <%s>", qPrintable(name));
             return false;
             }
 
-      EventMap events;
-      // score->renderMidi(&events, synthesizerState());
-      score->renderMidi(&events, SynthesizerState());
-      if(events.size() == 0)
-            return false;
-
-      MasterSynthesizer* synth = synthesizerFactory();
-      synth->init();
       // int sampleRate = preferences.getInt(PREF_EXPORT_AUDIO_SAMPLERATE);
       int sampleRate = 44100;
-      synth->setSampleRate(sampleRate);
-      bool r = synth->setState(score->synthesizerState());
-      if (!r)
-            synth->init();
-
-      int oldSampleRate  = MScore::sampleRate;
-      MScore::sampleRate = sampleRate;
-
 
       SoundFileDevice device(sampleRate, format, name);
 
@@ -603,9 +858,6 @@ bool saveAudio(Score* score, const QString& name)
       progress.close();
 #endif
 
-      MScore::sampleRate = oldSampleRate;
-      delete synth;
-
 #if 0
       if (wasCanceled)
             QFile::remove(name);
@@ -614,6 +866,107 @@ bool saveAudio(Score* score, const QString& name)
       return result;
       }
 
+//---------------------------------------------------------
+//   encodeAudio
+//    encode the whole score into data, without a
+//    round trip through a file
+//    With normalize (the default, like saveAudio()), the
+//    samples are all buffered first (see PcmBuffer, 10.6 MB
+//    per minute of audio, and the temporary file is in
+//    memory too on wasm). Without, they are encoded as they
+//    are synthesized.
+//---------------------------------------------------------
+
+bool encodeAudio(Score* score, const QString& format, QByteArray* data, bool normalize)
+      {
+      int sfFormat = audioFileFormat(format);
+      if (!sfFormat) {
+            qDebug("unknown audio format <%s>", qPrintable(format));
+            return false;
+            }
+
+      AudioSink sink;
+      SoundFileDevice device(44100, sfFormat, &sink);
+      bool result = saveAudio(score, &device, [](float, float) { return true; }, 0, normalize);
+      *data = sink.take();
+      return result;
+      }
+
+static const unsigned ENCODE_SYNTH_CHUNKS = 256;   // ~3 seconds of audio per call
+
+///
+/// \brief Encode the score progressively, see synthAudioWorklet
+/// \param score The score to output
+/// \param format The file extension of the output format
+/// \return The iterator function, or nullptr on error
+///
+/// Every call synthesizes the next few seconds and returns the encoded bytes in SynthRes::chunk.
+/// Only ogg can be handed out while encoding, wav, flac and mp3 seek back to their header when they are closed,
+/// so all their data is returned by the last call.
+/// The output is not normalized.
+///
+std::function<SynthRes*(bool)> encodeAudioWorklet(Score* score, const QString& format)
+      {
+      int sfFormat = audioFileFormat(format);
+      if (!sfFormat) {
+            qDebug("unknown audio format <%s>", qPrintable(format));
+            return nullptr;
+            }
+
+      std::function<SynthRes*(bool)> synthFn = synthAudioWorklet(score, 0);
+      if (!synthFn)
+            return nullptr;
+
+      struct Encoder {
+            AudioSink sink;
+            SoundFileDevice device;   // closed before the sink is gone
+            Encoder(int format) : device(44100, format, &sink) {}
+            };
+      auto encoder = std::make_shared<Encoder>(sfFormat);
+      if (!encoder->device.open(QIODevice::WriteOnly)) {
+            free(synthFn(true));   // cancel, free the synthesizer
+            return nullptr;
+            }
+      const bool streaming = (sfFormat & SF_FORMAT_TYPEMASK) == SF_FORMAT_OGG;
+
+      bool done = false;
+
+      auto encodeIterator = [=](bool cancel = false) mutable -> SynthRes* {
+            float startTime = -1;
+            float endTime = -1;
+            float buffer[SYNTH_FRAMES * 2];
+
+            for (unsigned i = 0; i < ENCODE_SYNTH_CHUNKS && !done; ++i) {
+                  SynthRes* res = synthFn(cancel);
+                  if (res->startTime >= 0) {
+                        if (startTime < 0)
+                              startTime = res->startTime;
+                        endTime = res->endTime;
+                        interleave(buffer, reinterpret_cast<const float*>(res->chunk), SYNTH_FRAMES);
+                        encoder->device.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+                        }
+                  if (res->done) {
+                        encoder->device.close();
+                        done = true;
+                        }
+                  free(res);
+                  }
+
+            QByteArray data;
+            if (done || streaming)
+                  data = encoder->sink.take();
+
+            auto res = (SynthRes*)calloc(1, sizeof(SynthRes) + data.size());
+            res->done = done;
+            res->startTime = startTime;
+            res->endTime = endTime;
+            res->chunkSize = data.size();
+            memcpy(res->chunk, data.constData(), data.size());
+            return res;
+            };
+
+      return encodeIterator;
+      }
+
 #endif // HAS_AUDIOFILE
 }
-
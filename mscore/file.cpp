@@ -96,6 +96,7 @@
 #include "libmscore/chordlist.h"
 #include "libmscore/mscore.h"
 #include "libmscore/importexports.h"
+#include "libmscore/taskpool.h"
 // #include "thirdparty/qzip/qzipreader_p.h"
 // #include "migration/scoremigrator_3_6.h"
 // #include "migration/handlers/styledefaultshandler.h"
@@ -107,6 +108,7 @@
 namespace Ms {
 
 int trimMargin = -1;
+bool svgGlyphDefs = false;
 
 // extern void importSoundfont(QString name);
 
@@ -2072,17 +2074,19 @@ bool MuseScore::savePdf(Score* cs_, const QString& saveName)
 #endif
 
 //---------------------------------------------------------
-//   savePdf using QPdfWriter
+//   printPdf
+//    the printing state (Score::setPrinting(),
+//    MScore::pdfPrinting and pixelRatio) is set by the
+//    caller, see savePdf() and savePdfAll()
 //---------------------------------------------------------
 
-bool savePdf(Score* cs_, QIODevice* device)
-      {
-      cs_->setPrinting(true);
-      MScore::pdfPrinting = true;
+static const int PDF_RESOLUTION = 300;
 
+static bool printPdf(Score* cs_, QIODevice* device)
+      {
       QPdfWriter pdfWriter(device);
 
-      pdfWriter.setResolution(300);
+      pdfWriter.setResolution(PDF_RESOLUTION);
       // printer.setResolution(preferences.getInt(PREF_EXPORT_PDF_DPI));
       QSizeF size(cs_->styleD(Sid::pageWidth), cs_->styleD(Sid::pageHeight));
       pdfWriter.setPageSize(QPageSize(size, QPageSize::Inch));
@@ -2114,9 +2118,6 @@ bool savePdf(Score* cs_, QIODevice* device)
          size.height() * pdfWriter.logicalDpiY()));
       p.setWindow(QRect(0.0, 0.0, size.width() * DPI, size.height() * DPI));
 
-      double pr = MScore::pixelRatio;
-      MScore::pixelRatio = DPI / pdfWriter.logicalDpiX();
-
       const QList<Page*> pl = cs_->pages();
       int pages = pl.size();
       bool firstPage = true;
@@ -2127,11 +2128,72 @@ bool savePdf(Score* cs_, QIODevice* device)
             cs_->print(&p, n);
             }
       p.end();
+      return true;
+      }
+
+//---------------------------------------------------------
+//   savePdf using QPdfWriter
+//---------------------------------------------------------
+
+bool savePdf(Score* cs_, QIODevice* device)
+      {
+      cs_->setPrinting(true);
+      MScore::pdfPrinting = true;
+      double pr = MScore::pixelRatio;
+      MScore::pixelRatio = DPI / PDF_RESOLUTION;
+
+      bool rv = printPdf(cs_, device);
+
       cs_->setPrinting(false);
+      MScore::pixelRatio = pr;
+      MScore::pdfPrinting = false;
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   savePdfAll
+///  Save several scores (e.g. the parts) as one PDF each,
+///  the scores are printed in parallel
+//---------------------------------------------------------
 
+QList<QByteArray> savePdfAll(const QList<Score*>& scores)
+      {
+      const int n = scores.size();
+      TaskPool* pool = TaskPool::instance();
+      const bool parallel = pool->threads() > 1 && n > 1;
+
+      MScore::pdfPrinting = true;
+      double pr = MScore::pixelRatio;
+      MScore::pixelRatio = DPI / PDF_RESOLUTION;
+      for (Score* s : scores) {
+            s->setPrinting(true);
+            if (parallel) {
+                  // the lazily built lookups are only safe from several threads once built
+                  s->spannerMap().updateIfDirty();
+                  s->updateMeasureTickIndex();
+                  }
+            }
+      if (parallel)
+            ScoreFont::computeAllMetrics();
+
+      std::vector<QByteArray> pdfs(n);
+      auto print = [&](int i) {
+            QBuffer buffer(&pdfs[i]);
+            buffer.open(QIODevice::WriteOnly);
+            printPdf(scores[i], &buffer);
+            };
+      if (parallel)
+            pool->parallelFor(n, print);
+      else {
+            for (int i = 0; i < n; ++i)
+                  print(i);
+            }
+
+      for (Score* s : scores)
+            s->setPrinting(false);
       MScore::pixelRatio = pr;
       MScore::pdfPrinting = false;
-      return true;
+      return QList<QByteArray>::fromVector(QVector<QByteArray>::fromStdVector(pdfs));
       }
 
 #if 0
@@ -2668,11 +2730,11 @@ bool MuseScore::savePng(Score* score, const QString& name, SaveReplacePolicy* re
 #endif
 
 //---------------------------------------------------------
-//   savePng with options
-//    return true on success
+//   pngPage
+//    paint a page for savePng()
 //---------------------------------------------------------
 
-bool savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground, bool transparent)
+static QImage pngPage(Score* score, int pageNumber, bool drawPageBackground, bool transparent)
       {
       const bool screenshot = false;
       const bool _transparent = transparent && !drawPageBackground;
@@ -2682,7 +2744,6 @@ bool savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
       const int localTrimMargin = trimMargin;
       const QImage::Format format = QImage::Format_ARGB32_Premultiplied;
 
-      bool rv = true;
       score->setPrinting(!screenshot);    // don’t print page break symbols etc.
       double pr = MScore::pixelRatio;
 
@@ -2723,6 +2784,7 @@ bool savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
       QList< Element*> pel = page->elements();
       std::stable_sort(pel.begin(), pel.end(), elementLessThan);
       paintElements(p, pel);
+      p.end();
        if (format == QImage::Format_Indexed8) {
             //convert to grayscale & respect alpha
             QVector<QRgb> colorTable;
@@ -2737,10 +2799,52 @@ bool savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
                   }
             printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
             }
-      printer.save(device, "png");
       score->setPrinting(false);
       MScore::pixelRatio = pr;
-      return rv;
+      return printer;
+      }
+
+//---------------------------------------------------------
+//   savePng with options
+//    return true on success
+//---------------------------------------------------------
+
+bool savePng(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground, bool transparent)
+      {
+      pngPage(score, pageNumber, drawPageBackground, transparent).save(device, "png");
+      return true;
+      }
+
+//---------------------------------------------------------
+//   savePngAll
+//    all pages as PNG
+//    The pages are painted one after another (the glyphs
+//    are drawn from a QPixmap cache), but encoded in
+//    parallel with the painting of the next pages.
+//---------------------------------------------------------
+
+QList<QByteArray> savePngAll(Score* score, bool drawPageBackground, bool transparent)
+      {
+      const int pages = score->pages().size();
+      std::vector<QByteArray> pngs(pages);
+      std::vector<std::future<void>> encoding;
+      TaskPool* pool = TaskPool::instance();
+      for (int i = 0; i < pages; ++i) {
+            QImage image = pngPage(score, i, drawPageBackground, transparent);
+            QByteArray* png = &pngs[i];
+            auto encode = [image, png]() {
+                  QBuffer buffer(png);
+                  buffer.open(QIODevice::WriteOnly);
+                  image.save(&buffer, "png");
+                  };
+            if (pool->threads() > 1)
+                  encoding.push_back(pool->run(encode));
+            else
+                  encode();
+            }
+      for (std::future<void>& f : encoding)
+            f.wait();
+      return QList<QByteArray>::fromVector(QVector<QByteArray>::fromStdVector(pngs));
       }
 
 #if 0
@@ -2958,23 +3062,69 @@ NotesColors readNotesColors(const QString& filePath)
 }
 
 //---------------------------------------------------------
-//   MuseScore::saveSvg
-///  Save a single page as SVG
+//   pageNoteCount
+//    the number of notes on the page, used as the note
+//    index offset of the following pages (see saveSvg)
 //---------------------------------------------------------
-bool saveSvg(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground, const NotesColors& notesColors)
+
+static int pageNoteCount(Page* page)
+      {
+      int n = 0;
+      for (const Element* element : page->elements()) {
+            if (element->type() == ElementType::NOTE)
+                  n++;
+            }
+      return n;
+      }
+
+//---------------------------------------------------------
+//   beginSvgPrinting
+//    set the printing state for SVG pages, returns the
+//    pixel ratio to restore in endSvgPrinting()
+//---------------------------------------------------------
+
+static double beginSvgPrinting(Score* score)
       {
-      QString title(score->title());
       score->setPrinting(true);
       MScore::pdfPrinting = true;
       MScore::svgPrinting = true;
+      double pr = MScore::pixelRatio;
+      MScore::pixelRatio = DPI / SvgGenerator().logicalDpiX();
+      return pr;
+      }
+
+//---------------------------------------------------------
+//   endSvgPrinting
+//---------------------------------------------------------
+
+static void endSvgPrinting(Score* score, double pr)
+      {
+      MScore::pixelRatio = pr;
+      score->setPrinting(false);
+      MScore::pdfPrinting = false;
+      MScore::svgPrinting = false;
+      }
+
+//---------------------------------------------------------
+//   saveSvgPage
+//    lastNoteIndex: index of the last note on the previous
+//    pages, only used with notesColors
+//    Only reads the score and the printing state, see
+//    beginSvgPrinting(), and can be called for several
+//    pages in parallel without notesColors.
+//---------------------------------------------------------
+
+static bool saveSvgPage(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground, const NotesColors& notesColors, int lastNoteIndex)
+      {
+      QString title(score->title());
       const QList<Page*>& pl = score->pages();
       int pages = pl.size();
-      double pr = MScore::pixelRatio;
 
       Page* page = pl.at(pageNumber);
       SvgGenerator printer;
       printer.setTitle(pages > 1 ? QString("%1 (%2)").arg(title).arg(pageNumber + 1) : title);
       printer.setOutputDevice(device);
+      printer.setGlyphDefs(svgGlyphDefs);
 
       QRectF r;
       if (trimMargin >= 0) {
@@ -2992,7 +3142,6 @@ bool saveSvg(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
       p.setRenderHint(QPainter::TextAntialiasing, true);
       if (trimMargin >= 0 && score->npages() == 1)
             p.translate(-r.topLeft());
-      MScore::pixelRatio = DPI / printer.logicalDpiX();
 
       if (drawPageBackground)
             p.fillRect(r, Qt::white);
@@ -3057,15 +3206,6 @@ bool saveSvg(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
       std::stable_sort(pel.begin(), pel.end(), elementLessThan);
       ElementType eType;
 
-      int lastNoteIndex = -1;
-      for (int i = 0; i < pageNumber; ++i) {
-          for (const Element* element: score->pages()[i]->elements()) {
-              if (element->type() == ElementType::NOTE) {
-                  lastNoteIndex++;
-              }
-          }
-      }
-
       for (const Element* e : pel) {
             // Always exclude invisible elements
             if (!e->visible())
@@ -3101,15 +3241,69 @@ bool saveSvg(Score* score, QIODevice* device, int pageNumber, bool drawPageBackg
             }
             }
       p.end(); // Writes MuseScore SVG file to disk, finally
-
-      // Clean up and return
-      MScore::pixelRatio = pr;
-      score->setPrinting(false);
-      MScore::pdfPrinting = false;
-      MScore::svgPrinting = false;
       return true;
       }
 
+//---------------------------------------------------------
+//   MuseScore::saveSvg
+///  Save a single page as SVG
+//---------------------------------------------------------
+
+bool saveSvg(Score* score, QIODevice* device, int pageNumber, bool drawPageBackground, const NotesColors& notesColors)
+      {
+      int lastNoteIndex = -1;
+      if (!notesColors.isEmpty()) {
+            for (int i = 0; i < pageNumber; ++i)
+                  lastNoteIndex += pageNoteCount(score->pages()[i]);
+            }
+      double pr = beginSvgPrinting(score);
+      bool rv = saveSvgPage(score, device, pageNumber, drawPageBackground, notesColors, lastNoteIndex);
+      endSvgPrinting(score, pr);
+      return rv;
+      }
+
+//---------------------------------------------------------
+//   saveSvgAll
+///  Save all pages as SVG, the note indices (notesColors)
+///  continue from page to page.
+///  The pages are painted in parallel, except with
+///  notesColors (the colored notes are painted from clones).
+//---------------------------------------------------------
+
+QList<QByteArray> saveSvgAll(Score* score, bool drawPageBackground, const NotesColors& notesColors)
+      {
+      const QList<Page*>& pl = score->pages();
+      const int pages = pl.size();
+      std::vector<int> lastNoteIndex(pages, -1);
+      if (!notesColors.isEmpty()) {
+            for (int i = 1; i < pages; ++i)
+                  lastNoteIndex[i] = lastNoteIndex[i - 1] + pageNoteCount(pl.at(i - 1));
+            }
+
+      std::vector<QByteArray> svgs(pages);
+      auto savePage = [&](int i) {
+            QBuffer buffer(&svgs[i]);
+            buffer.open(QIODevice::WriteOnly);
+            saveSvgPage(score, &buffer, i, drawPageBackground, notesColors, lastNoteIndex[i]);
+            };
+
+      double pr = beginSvgPrinting(score);
+      TaskPool* pool = TaskPool::instance();
+      if (pool->threads() > 1 && pages > 1 && notesColors.isEmpty()) {
+            // the lazily built lookups are only safe from several threads once built
+            score->spannerMap().updateIfDirty();
+            score->updateMeasureTickIndex();
+            ScoreFont::computeAllMetrics();
+            pool->parallelFor(pages, savePage);
+            }
+      else {
+            for (int i = 0; i < pages; ++i)
+                  savePage(i);
+            }
+      endSvgPrinting(score, pr);
+      return QList<QByteArray>::fromVector(QVector<QByteArray>::fromStdVector(svgs));
+      }
+
 #if 0
 
 //---------------------------------------------------------
@@ -3174,39 +3368,13 @@ bool MuseScore::saveMetadataJSON(Score* score, const QString& name)
       }
 #endif
 
-//---------------------------------------------------------
-//   Helper Function:
-// 
-//   findTextByType
-//    @data must contain std::pair<Tid, QStringList*>*
-//          Tid specifies text style
-//          QStringList* specifies the container to keep found text
-//
-//    For usage with Score::scanElements().
-//    Finds all text elements with specified style.
-//---------------------------------------------------------
-static void findTextByType(void* data, Element* element)
-      {
-      if (!element->isTextBase())
-            return;
-      TextBase* text = toTextBase(element);
-      auto* typeStringsData = static_cast<std::pair<Tid, QStringList*>*>(data);
-      if (text->tid() == typeStringsData->first) {
-            // or if score->getTextStyleUserName().contains("Title") ???
-            // That is bad since it may be localized
-            QStringList* titleStrings = typeStringsData->second;
-            Q_ASSERT(titleStrings);
-            titleStrings->append(text->plainText());
-            }
-      }
-
 //---------------------------------------------------------
 //   saveMetadataJSON
 //---------------------------------------------------------
 
 static auto boolToString = [](bool b) { return b ? "true" : "false"; };
 
-QJsonObject savePartInfoJSON(Part* p) {
+QJsonObject savePartInfoJSON(Part* p, const ScoreStatistics& stats) {
       QJsonObject jsonPart;
       jsonPart.insert("name", p->longName().replace("\n", ""));
       int midiProgram = p->midiProgram();
@@ -3215,8 +3383,10 @@ QJsonObject savePartInfoJSON(Part* p) {
       jsonPart.insert("program", midiProgram);
       jsonPart.insert("instrumentId", p->instrumentId());
       jsonPart.insert("instrumentName", p->instrumentName());
-      jsonPart.insert("lyricCount", p->lyricCount());
-      jsonPart.insert("harmonyCount", p->harmonyCount());
+      // the parts of excerpts are those of the score, unless the excerpt has its own
+      auto counts = stats.parts.constFind(p);
+      jsonPart.insert("lyricCount", counts != stats.parts.cend() ? counts->lyricCount : p->lyricCount());
+      jsonPart.insert("harmonyCount", counts != stats.parts.cend() ? counts->harmonyCount : p->harmonyCount());
       jsonPart.insert("hasPitchedStaff", boolToString(p->hasPitchedStaff()));
       jsonPart.insert("hasTabStaff", boolToString(p->hasTabStaff()));
       jsonPart.insert("hasDrumStaff", boolToString(p->hasDrumStaff()));
@@ -3228,6 +3398,7 @@ QJsonObject savePartInfoJSON(Part* p) {
 QJsonObject saveMetadataJSON(Score* score)
       {
       QJsonObject json;
+      const ScoreStatistics& stats = score->statistics();
 
       // title
       QString title;
@@ -3270,8 +3441,8 @@ QJsonObject saveMetadataJSON(Score* score)
 
       json.insert("pages", score->npages());
       json.insert("measures", score->nmeasures());
-      json.insert("hasLyrics", boolToString(score->hasLyrics()));
-      json.insert("hasHarmonies", boolToString(score->hasHarmonies()));
+      json.insert("hasLyrics", boolToString(stats.hasLyrics));
+      json.insert("hasHarmonies", boolToString(stats.hasHarmonies));
       json.insert("keysig", score->keysig());
       json.insert("previousSource", score->metaTag("source"));
 
@@ -3293,29 +3464,15 @@ QJsonObject saveMetadataJSON(Score* score)
             }
       json.insert("timesig", timeSig);
 
-      json.insert("duration", score->durationDouble());
-      json.insert("lyrics", score->extractLyrics());
-
-      // tempo
-       int tempo = 0;
-       QString tempoText;
-       for (Segment* seg = score->firstSegmentMM(SegmentType::All); seg; seg = seg->next1MM()) {
-             auto annotations = seg->annotations();
-             for (Element* a : annotations) {
-                   if (a && a->isTempoText()) {
-                         TempoText* tt = toTempoText(a);
-                         tempo = round(tt->tempo() * 60);
-                         tempoText = tt->xmlText();
-                         }
-                   }
-             }
-      json.insert("tempo", tempo);
-      json.insert("tempoText", tempoText);
+      json.insert("duration", stats.duration);
+      json.insert("lyrics", stats.lyrics);
+      json.insert("tempo", stats.tempo);
+      json.insert("tempoText", stats.tempoText);
 
       // parts
       QJsonArray jsonPartsArray;
       for (Part* p : score->parts()) {
-            jsonPartsArray.append(savePartInfoJSON(p));
+            jsonPartsArray.append(savePartInfoJSON(p, stats));
       }
       json.insert("parts", jsonPartsArray);
 
@@ -3328,21 +3485,14 @@ QJsonObject saveMetadataJSON(Score* score)
 
       //text frames metadata
       QJsonObject jsonTypeData;
-      static std::vector<std::pair<QString, Tid>> namesTypesList {
-            {"titles", Tid::TITLE},
-            {"subtitles", Tid::SUBTITLE},
-            {"composers", Tid::COMPOSER},
-            {"poets", Tid::POET}
+      const std::vector<std::pair<QString, const QStringList*>> namesTextsList {
+            {"titles", &stats.titles},
+            {"subtitles", &stats.subtitles},
+            {"composers", &stats.composers},
+            {"poets", &stats.poets}
             };
-      for (auto nameType : namesTypesList) {
-            QJsonArray typeData;
-            QStringList typeTextStrings;
-            std::pair<Tid, QStringList*> extendedTitleData = std::make_pair(nameType.second, &typeTextStrings);
-            score->scanElements(&extendedTitleData, findTextByType);
-            for (auto typeStr : typeTextStrings)
-                  typeData.append(typeStr);
-            jsonTypeData.insert(nameType.first, typeData);
-            }
+      for (auto nameTexts : namesTextsList)
+            jsonTypeData.insert(nameTexts.first, QJsonArray::fromStringList(*nameTexts.second));
       json.insert("textFramesData", jsonTypeData);
 
       // excerpts (linked parts)
@@ -3357,7 +3507,7 @@ QJsonObject saveMetadataJSON(Score* score)
             jsonExcerpt.insert("title", e->title());
             QJsonArray parts;
             for (Part* p : e->parts()) {
-                  parts.append(savePartInfoJSON(p));
+                  parts.append(savePartInfoJSON(p, stats));
             }
             jsonExcerpt.insert("parts", parts);
 
@@ -31,6 +31,7 @@ extern bool converterMode;
 extern bool pluginMode;
 extern double guiScaling;
 extern int trimMargin;
+extern bool svgGlyphDefs;    ///< SVG export: glyph outlines in <defs>, referenced by <use>
 extern bool noWebView;
 extern bool ignoreWarnings;
 
@@ -29,12 +29,12 @@ namespace Ms {
 //   saveMeasureEvents
 //---------------------------------------------------------
 
-void saveMeasureEvents(QJsonArray& jsonEventsArray, Measure* m, int offset, QHash<void*, int>* segs)
+void saveMeasureEvents(QJsonArray& jsonEventsArray, Measure* m, int offset, QHash<void*, int>* segs, TimeCursor& timeCursor)
 {
       for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
             int tick = s->tick().ticks() + offset;
             int id = (*segs)[(void*)s];
-            int time = lrint(m->score()->repeatList().utick2utime(tick) * 1000);
+            int time = lrint(timeCursor.utick2utime(tick) * 1000);
 
             QJsonObject jsonEvent;
             jsonEvent.insert("elid", id);
@@ -122,17 +122,18 @@ QJsonObject savePositions(Score* score, bool segments)
 
       QJsonArray jsonEventsArray;
       score->masterScore()->setExpandRepeats(true);
+      TimeCursor timeCursor(score->repeatList());  // events are generated in playback order
       for (const RepeatSegment* rs : score->repeatList()) {
             int startTick  = rs->tick;
             int endTick    = startTick + rs->len();
             int tickOffset = rs->utick - rs->tick;
             for (Measure* m = score->tick2measureMM(Fraction::fromTicks(startTick)); m; m = m->nextMeasureMM()) {
                         if (segments)
-                              saveMeasureEvents(jsonEventsArray, m, tickOffset, &segs);
+                              saveMeasureEvents(jsonEventsArray, m, tickOffset, &segs, timeCursor);
                         else {
                               int tick = m->tick().ticks() + tickOffset;
                               int i = segs[(void*)m];
-                              int time = lrint(m->score()->repeatList().utick2utime(tick) * 1000);
+                              int time = lrint(timeCursor.utick2utime(tick) * 1000);
                               
                               QJsonObject jsonEvent;
                               jsonEvent.insert("elid", i);
@@ -791,8 +791,8 @@ void Seq::process(unsigned framesPerPeriod, float* buffer)
                   return;
 
             // if currently in count-in, these pointers will reference data in the count-in
-            EventMap::const_iterator* pPlayPos   = &playPos;
-            EventMap::const_iterator  pEventsEnd = eventsEnd;
+            PlayEventMap::const_iterator* pPlayPos   = &playPos;
+            PlayEventMap::const_iterator  pEventsEnd = eventsEnd;
             int*                      pPlayFrame = &playFrame;
             if (inCountIn) {
                   if (countInEvents.size() == 0)
@@ -1092,7 +1092,10 @@ void Seq::collectEvents(int utick)
             const MidiRenderer::Chunk chunk = midi.getChunkAt(unrenderedUtick);
             if (!chunk)
                   break;
-            renderChunk(chunk, &events);
+            // the renderer works on a (flat) EventMap, the playlist is a PlayEventMap
+            renderChunk(chunk, &renderEvents);
+            events.insert(renderEvents.begin(), renderEvents.end());
+            renderEvents.clear();
             unrenderedUtick = renderEventsStatus.occupiedRangeEnd(utick);
             }
 
@@ -1430,7 +1433,7 @@ void Seq::prevChord()
       {
       int t  = playPos->first;
       //find the chord just before playpos
-      EventMap::const_iterator i = events.upper_bound(cs->repeatList().tick2utick(t));
+      PlayEventMap::const_iterator i = events.upper_bound(cs->repeatList().tick2utick(t));
       for (;;) {
             if (i->second.type() == ME_NOTEON) {
                   const NPlayEvent& n = i->second;
@@ -1690,9 +1693,9 @@ void Seq::updateSynthesizerState(int tick1, int tick2)
             tick1 = 0;
       // Making a local copy of events to avoid touching it
       // from different threads at the same time
-      EventMap ev = events;
-      EventMap::const_iterator i1 = ev.lower_bound(tick1);
-      EventMap::const_iterator i2 = ev.upper_bound(tick2);
+      PlayEventMap ev = events;
+      PlayEventMap::const_iterator i1 = ev.lower_bound(tick1);
+      PlayEventMap::const_iterator i2 = ev.upper_bound(tick2);
 
       for (; i1 != i2; ++i1) {
             if (i1->second.type() == ME_CONTROLLER)
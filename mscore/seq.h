@@ -135,24 +135,24 @@ class Seq : public QObject, public Sequencer {
       double meterPeakValue[2];
       int peakTimer[2];
 
-      EventMap events;                    // playlist for playback mode
-      EventMap::const_iterator eventsEnd;
+      PlayEventMap events;                // playlist for playback mode
+      PlayEventMap::const_iterator eventsEnd;
       EventMap renderEvents;              // event list that is rendered in background
       RangeMap renderEventsStatus;
       MidiRenderer midi;
       QFuture<void> midiRenderFuture;
       bool allowBackgroundRendering = false; // should be set to true only when playing, so no
                                              // score changes are possible.
-      EventMap countInEvents;             // playlist of any metronome countin clicks
+      PlayEventMap countInEvents;         // playlist of any metronome countin clicks
       QQueue<NPlayEvent> _liveEventQueue; // playlist for score editing and note entry (rendered live)
 
       int playFrame;                      // current play position in samples, relative to the first frame of playback
       int countInPlayFrame;               // current play position in samples, relative to the first frame of countin
       int endUTick;                       // the final tick of midi events collected by collectEvents()
 
-      EventMap::const_iterator playPos;   // moved in real time thread
-      EventMap::const_iterator countInPlayPos;
-      EventMap::const_iterator guiPos;    // moved in gui thread
+      PlayEventMap::const_iterator playPos;   // moved in real time thread
+      PlayEventMap::const_iterator countInPlayPos;
+      PlayEventMap::const_iterator guiPos;    // moved in gui thread
 
       QList<const Note*> markedNotes;     // notes marked as sounding
 
@@ -183,7 +183,7 @@ public:
     int resolution;
 
     QString header;
-//    QString defs; // NEEDED FOR GRADIENTS
+    QString defs; // glyph outlines, see SvgGenerator::setGlyphDefs()
     QString body;
 
     QBrush brush;
@@ -240,6 +240,14 @@ private:
     qreal _dx { 0.0 };
     qreal _dy { 0.0 };
 
+// Glyph outlines go to <defs> once, and are referenced by <use>
+    bool _glyphDefs { false };
+    bool _glyph     { false }; // inside drawTextItem()
+    QHash<QString, int> _glyphIds;
+
+    QString pathData(const QPainterPath &p, qreal dx, qreal dy) const;
+    void drawGlyph(const QPainterPath &p);
+
 protected:
 // The Ms::Element being generated right now
     const Ms::Element* _element = NULL;
@@ -290,6 +298,13 @@ protected:
 
 #define SVG_IMAGE       "<image"
 #define SVG_PATH        "<path"
+#define SVG_USE         "<use"
+#define SVG_ID          " id=\""
+#define SVG_HREF        " xlink:href=\"#"
+#define SVG_GLYPH_ID    'g'
+
+#define SVG_DEFS_BEGIN  "<defs>"
+#define SVG_DEFS_END    "</defs>"
 #define SVG_POLYLINE    "<polyline"
 
 #define SVG_PRESERVE_ASPECT " preserveAspectRatio=\""
@@ -330,6 +345,7 @@ public:
     void popGroup();
 
     void drawPath(const QPainterPath &path);
+    void drawTextItem(const QPointF &p, const QTextItem &textItem);
     void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr);
     void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode);
     void drawImage(const QRectF &r, const QImage &pm, const QRectF &sr,
@@ -1003,6 +1019,31 @@ void SvgGenerator::setElement(const Ms::Element* e) {
     static_cast<SvgPaintEngine*>(paintEngine())->_element = e;
 }
 
+/*!
+    \property SvgGenerator::glyphDefs
+    \brief whether glyph outlines are written once to <defs>
+
+    Text and symbols (noteheads, accidentals, flags, clefs...) are drawn
+    as glyph outlines. With glyphDefs, each distinct outline is written
+    once to <defs>, and every occurrence is a <use> of it, instead of
+    a full <path>.
+*/
+bool SvgGenerator::glyphDefs() const
+{
+    Q_D(const SvgGenerator);
+    return d->engine->_glyphDefs;
+}
+
+void SvgGenerator::setGlyphDefs(bool on)
+{
+    Q_D(SvgGenerator);
+    if (d->engine->isActive()) {
+        qWarning("SvgGenerator::setGlyphDefs(), cannot set glyphDefs while SVG is being generated");
+        return;
+    }
+    d->engine->_glyphDefs = on;
+}
+
 /*****************************************************************************
  * class SvgPaintEngine
  */
@@ -1051,10 +1092,6 @@ bool SvgPaintEngine::begin(QPaintDevice *)
         stream() << SVG_DESC_BEGIN  << d->attributes.description.toHtmlEscaped() << SVG_DESC_END << endl;
     }
 
-// <defs> is currently empty. It's necessary for gradients.
-//    d->stream->setString(&d->defs);
-//    *d->stream << "<defs>\n";
-
     // Point the stream at the body string, for other functions to populate
     d->stream->setString(&d->body);
     return true;
@@ -1064,10 +1101,6 @@ bool SvgPaintEngine::end()
 {
     Q_D(SvgPaintEngine);
 
-// <defs> is currently empty
-//    d->stream->setString(&d->defs);
-//    stream() << "</defs>\n";
-
     // Point the stream at the real output device (the .svg file)
     d->stream->setDevice(d->outputDevice);
 
@@ -1077,7 +1110,9 @@ bool SvgPaintEngine::end()
 
     // Stream our strings out to the device, in order
     stream() << d->header;
-//    stream() << d->defs;
+    // <defs> only holds glyph outlines, it's empty without setGlyphDefs()
+    if (!d->defs.isEmpty())
+        stream() << SVG_DEFS_BEGIN << endl << d->defs << SVG_DEFS_END << endl;
     stream() << d->body;
     stream() << SVG_END << endl;
 
@@ -1198,6 +1233,11 @@ void SvgPaintEngine::updateState(const QPaintEngineState &s)
 
 void SvgPaintEngine::drawPath(const QPainterPath &p)
 {
+    if (_glyph && _glyphDefs) {
+        drawGlyph(p);
+        return;
+    }
+
     stream() << SVG_PATH << stateString;
 
     // fill-rule is here because UpdateState() doesn't have a QPainterPath arg
@@ -1206,26 +1246,34 @@ void SvgPaintEngine::drawPath(const QPainterPath &p)
         stream() << SVG_FILL_RULE;
 
     // Path data
-    stream() << SVG_D;
+    stream() << SVG_D << pathData(p, _dx, _dy) << SVG_QUOTE << SVG_ELEMENT_END << endl;
+}
+
+// The contents of the SVG d attribute, offset by dx, dy
+QString SvgPaintEngine::pathData(const QPainterPath &p, qreal dx, qreal dy) const
+{
+    QString     qs;
+    QTextStream qts(&qs);
+
     for (int i = 0; i < p.elementCount(); ++i) {
         const QPainterPath::Element &e = p.elementAt(i);
-                               qreal x = e.x + _dx;
-                               qreal y = e.y + _dy;
+                               qreal x = e.x + dx;
+                               qreal y = e.y + dy;
         switch (e.type) {
         case QPainterPath::MoveToElement:
-            stream() << SVG_MOVE  << x << SVG_COMMA << y;
+            qts << SVG_MOVE  << x << SVG_COMMA << y;
             break;
         case QPainterPath::LineToElement:
-            stream() << SVG_LINE  << x << SVG_COMMA << y;
+            qts << SVG_LINE  << x << SVG_COMMA << y;
             break;
         case QPainterPath::CurveToElement:
-            stream() << SVG_CURVE << x << SVG_COMMA << y;
+            qts << SVG_CURVE << x << SVG_COMMA << y;
             ++i;
             while (i < p.elementCount()) {
                 const QPainterPath::Element &ee = p.elementAt(i);
                 if (ee.type == QPainterPath::CurveToDataElement) {
-                    stream() << SVG_SPACE << ee.x + _dx
-                             << SVG_COMMA << ee.y + _dy;
+                    qts << SVG_SPACE << ee.x + dx
+                        << SVG_COMMA << ee.y + dy;
                     ++i;
                 }
                 else {
@@ -1238,9 +1286,49 @@ void SvgPaintEngine::drawPath(const QPainterPath &p)
             break;
         }
         if (i <= p.elementCount() - 1)
-            stream() << SVG_SPACE;
+            qts << SVG_SPACE;
+    }
+    qts.flush();
+    return qs;
+}
+
+// Glyph outlines are drawn at the origin (the position is in the transform),
+// so identical glyphs (same SymId and scale) have identical path data.
+// The outline is written to <defs> the first time, then referenced by <use>.
+void SvgPaintEngine::drawGlyph(const QPainterPath &p)
+{
+    Q_D(SvgPaintEngine);
+
+    // fill-rule is part of the outline, not of the <use>
+    QString outline = pathData(p, 0, 0);
+    if (p.fillRule() == Qt::OddEvenFill)
+        outline.prepend(SVG_FILL_RULE SVG_D);
+    else
+        outline.prepend(SVG_D);
+
+    int id = _glyphIds.value(outline, -1);
+    if (id < 0) {
+        id = _glyphIds.size();
+        _glyphIds.insert(outline, id);
+
+        QTextStream defs(&d->defs);
+        defs << SVG_PATH << SVG_ID << SVG_GLYPH_ID << id << SVG_QUOTE
+             << outline << SVG_QUOTE << SVG_ELEMENT_END << endl;
     }
-    stream() << SVG_QUOTE << SVG_ELEMENT_END << endl;
+
+    stream() << SVG_USE << SVG_HREF << SVG_GLYPH_ID << id << SVG_QUOTE << stateString;
+    if (_dx != 0 || _dy != 0)
+        stream() << SVG_X << SVG_QUOTE << _dx << SVG_QUOTE
+                 << SVG_Y << SVG_QUOTE << _dy << SVG_QUOTE;
+    stream() << SVG_ELEMENT_END << endl;
+}
+
+// QPaintEngine::drawTextItem() fills the glyph outlines with drawPath()
+void SvgPaintEngine::drawTextItem(const QPointF &p, const QTextItem &textItem)
+{
+    _glyph = true;
+    QPaintEngine::drawTextItem(p, textItem);
+    _glyph = false;
 }
 
 void SvgPaintEngine::drawPolygon(const QPointF *points, int pointCount,
@@ -65,6 +65,7 @@ class SvgGeneratorPrivate;
 //   @P fileName      QString
 //   @P outputDevice  QIODevice
 //   @P resolution    int
+//   @P glyphDefs     bool
 //---------------------------------------------------------
 
 class SvgGenerator : public QPaintDevice
@@ -78,6 +79,7 @@ class SvgGenerator : public QPaintDevice
     Q_PROPERTY(QString fileName READ fileName WRITE setFileName)
     Q_PROPERTY(QIODevice* outputDevice READ outputDevice WRITE setOutputDevice)
     Q_PROPERTY(int resolution READ resolution WRITE setResolution)
+    Q_PROPERTY(bool glyphDefs READ glyphDefs WRITE setGlyphDefs)
 public:
     SvgGenerator();
     ~SvgGenerator();
@@ -107,6 +109,9 @@ public:
 
     void setElement(const Ms::Element* e);
 
+    bool glyphDefs() const;
+    void setGlyphDefs(bool on);
+
 protected:
     QPaintEngine *paintEngine() const;
     int metric(QPaintDevice::PaintDeviceMetric metric) const;
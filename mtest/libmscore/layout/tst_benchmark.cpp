@@ -13,6 +13,7 @@
 #include <QtTest/QtTest>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/measure.h"
 
 #define DIR QString("libmscore/layout/")
 
@@ -39,6 +40,8 @@ class TestBenchmark : public QObject, public MTest
       void benchmark1();
       void benchmark2();
       void benchmark4();            // incremental layout (one page)
+      void benchmark5();            // tick -> measure lookup
+      void benchmark6();            // parse throughput (MB/s)
       };
 
 //---------------------------------------------------------
@@ -89,6 +92,51 @@ void TestBenchmark::benchmark4()
             }
       }
 
+//---------------------------------------------------------
+//   benchmark5
+//    tick2measure() over all measures of a long score
+//---------------------------------------------------------
+
+void TestBenchmark::benchmark5()
+      {
+      MasterScore* s = readScore("libmscore/concertpitch/concertpitchbenchmark.mscx");
+      QVERIFY(s);
+      s->doLayout();
+      QVERIFY(s->nmeasures() > 100);
+      QBENCHMARK {
+            for (Measure* m = s->firstMeasure(); m; m = m->nextMeasure()) {
+                  const Fraction tick = m->tick() + m->ticks() * Fraction(1,2);
+                  QCOMPARE(s->tick2measure(tick), m);
+                  QVERIFY(s->tick2measureMM(tick));
+                  }
+            }
+      delete s;
+      }
+
+//---------------------------------------------------------
+//   benchmark6
+//    read a few real scores (2.2 MB of mscx in total), the
+//    parse throughput is that size over the reported time
+//---------------------------------------------------------
+
+void TestBenchmark::benchmark6()
+      {
+      static const char* corpus[] = {
+            "libmscore/layout_elements/moonlight.mscx",
+            "libmscore/midi/testAndanteExcerpts.mscx",
+            "libmscore/concertpitch/concertpitchbenchmark.mscx",
+            };
+      QBENCHMARK {
+            for (const char* file : corpus) {
+                  QString path = root + "/" + file;
+                  MasterScore* s = new MasterScore(mscore->baseStyle());
+                  s->setName(path);
+                  QCOMPARE(s->loadMsc(path, false), Score::FileError::FILE_NO_ERROR);
+                  delete s;
+                  }
+            }
+      }
+
 QTEST_MAIN(TestBenchmark)
 #include "tst_benchmark.moc"
 
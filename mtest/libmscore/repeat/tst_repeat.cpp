@@ -141,11 +141,14 @@ void TestRepeat::repeat(const char* f1, const QString & ref)
       QVERIFY(score);
       score->setExpandRepeats(true);
       QStringList sl;
+      TimeCursor timeCursor(score->repeatList());
       for (const RepeatSegment* rs : score->repeatList()) {
             int startTick  = rs->tick;
             int endTick    = startTick + rs->len();
             for (Measure* m = score->tick2measure(Fraction::fromTicks(startTick)); m; m = m->nextMeasure()) {
                   sl.append(QString::number(m->no()+1));
+                  const int utick = m->tick().ticks() + rs->utick - rs->tick;
+                  QCOMPARE(timeCursor.utick2utime(utick), score->repeatList().utick2utime(utick));
                   if (m->endTick().ticks() >= endTick)
                         break;
                   }
@@ -11,10 +11,12 @@
 //=============================================================================
 
 #include <QtTest/QtTest>
+#include <random>
 #include "mtest/testutils.h"
 #include "libmscore/chord.h"
 #include "libmscore/excerpt.h"
 #include "libmscore/glissando.h"
+#include "libmscore/hairpin.h"
 #include "libmscore/layoutbreak.h"
 #include "libmscore/lyrics.h"
 #include "libmscore/measure.h"
@@ -55,6 +57,7 @@ class TestSpanners : public QObject, public MTest
       void spanners14();            // creating part from an existing grand staff containing a cross staff glissando
       void spanners15();            // change the color & min distance of a line and save it
       void spanners16();            // read lines with manual adjustments on a small staff and save
+      void spannerMap01();          // random add/remove/move, lookups against a linear scan
       };
 
 //---------------------------------------------------------
@@ -662,7 +665,93 @@ void TestSpanners::spanners16()
       delete score;
       }
 
+//---------------------------------------------------------
+//   checkSpannerMap
+//    compare findOverlapping() and findContained() with a
+//    linear scan of live, the results must be in start
+//    tick order
+//---------------------------------------------------------
+
+static bool checkSpannerMap(const SpannerMap& map, const std::vector<Spanner*>& live, int start, int stop)
+      {
+      for (bool contained : { false, true }) {
+            std::vector< ::Interval<Spanner*> > results = contained ? map.findContained(start, stop) : map.findOverlapping(start, stop);
+            std::set<Spanner*> found;
+            int lastStart = INT_MIN;
+            for (const auto& i : results) {
+                  if (i.start < lastStart || i.start != i.value->tick().ticks() || i.stop != i.value->tick2().ticks()) {
+                        qDebug("%s(%d, %d): bad interval %d-%d", contained ? "findContained" : "findOverlapping", start, stop, i.start, i.stop);
+                        return false;
+                        }
+                  lastStart = i.start;
+                  found.insert(i.value);
+                  }
+            std::set<Spanner*> expected;
+            for (Spanner* s : live) {
+                  const int t1 = s->tick().ticks();
+                  const int t2 = s->tick2().ticks();
+                  if (contained ? (t1 >= start && t2 <= stop) : (t1 <= stop && t2 >= start))
+                        expected.insert(s);
+                  }
+            if (found != expected || results.size() != expected.size()) {
+                  qDebug("%s(%d, %d): %d results, %d expected", contained ? "findContained" : "findOverlapping",
+                     start, stop, int(results.size()), int(expected.size()));
+                  return false;
+                  }
+            }
+      return true;
+      }
 
+//---------------------------------------------------------
+///  spannerMap01
+///   random adds, removes, setTick() and setTicks() on the
+///   spanners of a score, with and without rebuilding the
+///   lookup tree, checking the lookups after each step
+//---------------------------------------------------------
+
+void TestSpanners::spannerMap01()
+      {
+      MasterScore* score = new MasterScore(mscore->baseStyle());
+      SpannerMap& map = score->spannerMap();
+      std::vector<Spanner*> live;
+      std::vector<Spanner*> removed;
+      std::mt19937 rng(1);
+      auto random = [&rng](int n) { return int(rng() % unsigned(n)); };
+      const int maxTick = 100 * MScore::division;
+
+      for (int step = 0; step < 5000; ++step) {
+            const int op = random(10);
+            if (op < 4 || live.empty()) {
+                  Spanner* s = new Hairpin(score);
+                  s->setTick(Fraction::fromTicks(random(maxTick)));
+                  s->setTicks(Fraction::fromTicks(random(4) ? random(8 * MScore::division) : 0));
+                  map.addSpanner(s);
+                  live.push_back(s);
+                  }
+            else if (op < 6) {
+                  const int i = random(int(live.size()));
+                  QVERIFY(map.removeSpanner(live[i]));
+                  removed.push_back(live[i]);
+                  live.erase(live.begin() + i);
+                  }
+            else if (op < 8)
+                  live[random(int(live.size()))]->setTick(Fraction::fromTicks(random(maxTick)));
+            else if (op < 9)
+                  live[random(int(live.size()))]->setTicks(Fraction::fromTicks(random(8 * MScore::division)));
+            else if (random(4) == 0)
+                  map.setDirty();         // rebuilt by the next lookup
+            QCOMPARE(int(map.map().size()), int(live.size()));
+
+            const int start = random(maxTick + MScore::division) - MScore::division / 2;
+            const int stop  = start + random(10 * MScore::division);
+            QVERIFY(checkSpannerMap(map, live, start, stop));
+            QVERIFY(checkSpannerMap(map, live, start, start));
+            }
+      QVERIFY(checkSpannerMap(map, live, INT_MIN / 2, INT_MAX / 2));
+
+      qDeleteAll(removed);
+      delete score;           // deletes the spanners left in the map
+      }
 
 QTEST_MAIN(TestSpanners)
 #include "tst_spanners.moc"
@@ -0,0 +1,129 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2026 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/part.h"
+#include "libmscore/measure.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestStatistics
+//    Score::statistics(), the metadata of saveMetadataJSON
+//---------------------------------------------------------
+
+class TestStatistics : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      MasterScore* test_pre(const QString& file);
+      void compareQueries(MasterScore* score);
+
+   private slots:
+      void initTestCase();
+      void statisticsHarmonies();
+      void statisticsLyrics();
+      void statisticsTempo();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestStatistics::initTestCase()
+      {
+      initMTest();
+      }
+
+MasterScore* TestStatistics::test_pre(const QString& file)
+      {
+      MasterScore* score = readScore(file);
+      score->doLayout();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   compareQueries
+//    the collected values agree with the separate queries
+//---------------------------------------------------------
+
+void TestStatistics::compareQueries(MasterScore* score)
+      {
+      const ScoreStatistics& stats = score->statistics();
+      QCOMPARE(stats.hasHarmonies, score->hasHarmonies());
+      QCOMPARE(stats.hasLyrics, score->hasLyrics());
+      for (Part* part : score->parts()) {
+            QCOMPARE(stats.parts.value(part).harmonyCount, part->harmonyCount());
+            QCOMPARE(stats.parts.value(part).lyricCount, part->lyricCount());
+            }
+      QCOMPARE(stats.duration, score->durationDouble());
+      QCOMPARE(stats.lyrics, score->extractLyrics());
+      }
+
+//---------------------------------------------------------
+//   statisticsHarmonies
+//    cached, and collected again after an edit
+//---------------------------------------------------------
+
+void TestStatistics::statisticsHarmonies()
+      {
+      MasterScore* score = test_pre("libmscore/chordsymbol/clear.mscx");
+      compareQueries(score);
+      const ScoreStatistics* stats = &score->statistics();
+      QCOMPARE(stats->parts.value(score->parts().front()).harmonyCount, 2);
+      QVERIFY(&score->statistics() == stats);
+
+      score->startCmd();
+      score->select(score->firstMeasure(), SelectType::SINGLE, 0);
+      score->cmdDeleteSelection();
+      score->endCmd();
+      QVERIFY(!score->statistics().hasHarmonies);
+      compareQueries(score);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   statisticsLyrics
+//---------------------------------------------------------
+
+void TestStatistics::statisticsLyrics()
+      {
+      MasterScore* score = test_pre("libmscore/layout_elements/layout_elements.mscx");
+      QVERIFY(score->statistics().hasLyrics);
+      compareQueries(score);
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   statisticsTempo
+//    the last of the tempo texts (= 120, = 87, = 100),
+//    with and without multi measure rests
+//---------------------------------------------------------
+
+void TestStatistics::statisticsTempo()
+      {
+      for (bool mmRests : { false, true }) {
+            MasterScore* score = readScore("libmscore/midi/testPausesTempoTimesigChange.mscx");
+            score->style().set(Sid::createMultiMeasureRests, mmRests);
+            score->doLayout();
+            const ScoreStatistics& stats = score->statistics();
+            QCOMPARE(stats.tempo, 100);
+            QVERIFY(stats.tempoText.contains("= 100"));
+            delete score;
+            }
+      }
+
+QTEST_MAIN(TestStatistics)
+
+#include "tst_statistics.moc"
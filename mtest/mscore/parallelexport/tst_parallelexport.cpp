@@ -0,0 +1,155 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2026 MuseScore BVBA and others
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include <stdexcept>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/importexports.h"
+#include "libmscore/taskpool.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestParallelExport
+//    the exports painted on the TaskPool workers give the
+//    same output as the serial ones
+//    (only built with WEBMSCORE_THREADS, see mtest/CMakeLists.txt)
+//---------------------------------------------------------
+
+class TestParallelExport : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QList<MasterScore*> scores;
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+      void parallelForException();
+      void saveSvgAll();
+      void savePdfAll();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestParallelExport::initTestCase()
+      {
+      initMTest();
+      for (const char* file : { "libmscore/layout_elements/moonlight.mscx",
+                                "libmscore/midi/testAndanteExcerpts.mscx",
+                                "libmscore/layout_elements/layout_elements.mscx",
+                                "libmscore/chordsymbol/clear.mscx" }) {
+            MasterScore* score = readScore(file);
+            QVERIFY(score);
+            score->doLayout();
+            scores.append(score);
+            }
+      }
+
+void TestParallelExport::cleanupTestCase()
+      {
+      TaskPool::instance()->setThreads(1);
+      qDeleteAll(scores);
+      }
+
+//---------------------------------------------------------
+//   pdfWithoutIds
+//    the creation date and the document id differ
+//    from one PDF to the next
+//---------------------------------------------------------
+
+static QByteArray pdfWithoutIds(QByteArray pdf)
+      {
+      pdf.replace(QRegularExpression("D:\\d{14}[^)]*"), "D:");
+      pdf.replace(QRegularExpression("<xmp:(\\w*)Date>[^<]*</xmp:\\w*Date>"), "");
+      pdf.replace(QRegularExpression("uuid:[0-9a-fA-F-]+"), "uuid:");
+      pdf.replace(QRegularExpression("/ID \\[[^\\]]*\\]"), "/ID");
+      return pdf;
+      }
+
+//---------------------------------------------------------
+//   parallelForException
+//    an exception thrown by a call on any thread reaches
+//    the caller, after the other calls are done
+//---------------------------------------------------------
+
+void TestParallelExport::parallelForException()
+      {
+      TaskPool* pool = TaskPool::instance();
+      pool->setThreads(4);
+      for (int thrower = 0; thrower < 64; thrower += 7) {
+            QAtomicInt running;
+            bool caught = false;
+            try {
+                  pool->parallelFor(64, [&](int i) {
+                        running.ref();
+                        QThread::usleep(50);
+                        running.deref();
+                        if (i == thrower)
+                              throw std::runtime_error("parallelFor");
+                        });
+                  }
+            catch (const std::runtime_error&) {
+                  caught = true;
+                  }
+            QVERIFY(caught);
+            QCOMPARE(running.load(), 0);
+            }
+      // the pool is still usable
+      QAtomicInt calls;
+      pool->parallelFor(100, [&](int) { calls.ref(); });
+      QCOMPARE(calls.load(), 100);
+      }
+
+//---------------------------------------------------------
+//   saveSvgAll
+//---------------------------------------------------------
+
+void TestParallelExport::saveSvgAll()
+      {
+      for (MasterScore* score : scores) {
+            TaskPool::instance()->setThreads(1);
+            const QList<QByteArray> serial = Ms::saveSvgAll(score, true);
+            TaskPool::instance()->setThreads(4);
+            const QList<QByteArray> parallel = Ms::saveSvgAll(score, true);
+            QCOMPARE(serial.size(), score->npages());
+            QVERIFY(serial == parallel);
+            }
+      }
+
+//---------------------------------------------------------
+//   savePdfAll
+//---------------------------------------------------------
+
+void TestParallelExport::savePdfAll()
+      {
+      QList<Score*> list;
+      for (MasterScore* score : scores)
+            list.append(score);
+      TaskPool::instance()->setThreads(1);
+      const QList<QByteArray> serial = Ms::savePdfAll(list);
+      TaskPool::instance()->setThreads(4);
+      const QList<QByteArray> parallel = Ms::savePdfAll(list);
+      QCOMPARE(serial.size(), list.size());
+      QCOMPARE(parallel.size(), list.size());
+      for (int i = 0; i < list.size(); ++i) {
+            QVERIFY(serial[i].startsWith("%PDF"));
+            QVERIFY(pdfWithoutIds(serial[i]) == pdfWithoutIds(parallel[i]));
+            }
+      }
+
+QTEST_MAIN(TestParallelExport)
+
+#include "tst_parallelexport.moc"
@@ -0,0 +1,40 @@
+import WebMscore from 'webmscore'
+import { promises as fs } from 'fs'
+import { performance } from 'perf_hooks'
+
+const FILE = process.argv[2] || './Aequale_No_1.mscz'  // e.g. a long orchestral score
+const SOUNDFONT = process.argv[3] || '../share/sound/FluidR3Mono_GM.sf3'
+const CHUNKS = 100  // chunks to time at each position
+
+/**
+ * Average per-chunk latency of `synthAudio`, starting from `starttime`
+ * @param {import('webmscore').default} score 
+ * @param {number} starttime 
+ */
+const timeChunks = async (score, starttime) => {
+    const fn = await score.synthAudio(starttime)
+    const t0 = performance.now()
+    let n = 0
+    for (; n < CHUNKS; n++) {
+        const res = await fn()
+        if (res.done) { n++; break }
+    }
+    const total = performance.now() - t0
+    await fn(true)  // cancel, free the synthesizer
+    return total / n
+}
+
+WebMscore.ready.then(async () => {
+    await WebMscore.setSoundFont(await fs.readFile(SOUNDFONT))
+
+    const score = await WebMscore.load('mscz', await fs.readFile(FILE))
+    const { duration } = JSON.parse(await score.saveMetadata())
+
+    // the per-chunk cost should not depend on the playback position
+    for (const starttime of [0, duration / 2, Math.max(duration - 5, 0)]) {
+        const avg = await timeChunks(score, starttime)
+        console.log(`starttime: ${starttime.toFixed(1)} s, avg: ${avg.toFixed(3)} ms / chunk`)
+    }
+
+    score.destroy()
+})
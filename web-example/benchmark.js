@@ -4,7 +4,7 @@ import { promises as fs, watch } from 'fs'
 import { PerformanceObserver, performance } from 'perf_hooks'
 import { spawn } from 'child_process'
 
-const FILE = './Aequale_No_1.mscz'
+const FILE = process.argv[2] || './Aequale_No_1.mscz'  // e.g. a large orchestral score to measure load time
 const ROUNDS = 200
 
 const GROUPS = [   // [ webmscore method name , musescore output file extension ]
@@ -13,6 +13,7 @@ const GROUPS = [   // [ webmscore method name , musescore output file extension
     ['saveMidi', 'mid'],
     ['savePdf', 'pdf'],
     ['saveMetadata', 'metajson'],
+    ['load', 'mscz'],  // load (decompress & parse) only
 ]
 const GROUP_ID = 4  // saveMetadata
 const BOOST_MODE = true  // `savePdf` is not available under boost mode, `saveXml` and `saveMxl` cannot work properly
@@ -41,12 +42,37 @@ WebMscore.ready.then(async () => {
     for (let i = 0; i < ROUNDS; i++) {
         performance.mark('start')
         const score = await WebMscore.load('mscz', filedata, [], !BOOST_MODE)
-        await score[METHOD]()
+        if (METHOD !== 'load') {
+            await score[METHOD]()
+        }
         score.destroy()
         performance.measure(`${i}`, 'start')
     }
 })
 
+    // 
+    // benchmark using the native libwebmscore (`make native`), if WEBMSCORE_CLI is set to the webmscore-cli executable
+    // 
+    .then(async () => {
+        const CLI = process.env.WEBMSCORE_CLI
+        if (!CLI) return
+
+        const EXT = GROUPS[GROUP_ID][1]
+        await fs.mkdir('./benchmark/', { recursive: true })
+
+        const p = spawn(CLI, ['-r', `${ROUNDS}`, FILE, `./benchmark/native.${EXT}`])
+        let stderr = ''
+        p.stderr.on('data', (d) => { stderr += d })
+        await new Promise((resolve) => {
+            p.on('exit', resolve)
+        })
+
+        // rounds: ${ROUNDS}, total: ${total} ms, avg: ${avg} ms
+        console.log(`native webmscore: 
+        ${stderr.trim().split('\n').pop()}
+        `)
+    })
+
     // 
     // benchmark using musescore's built-in batch converter
     // 
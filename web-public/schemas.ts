@@ -66,6 +66,28 @@ interface ScoreExcerptData {
     parts: ScorePartData[];
 }
 
+/**
+ * `listExcerpts()`
+ */
+export interface ExcerptInfo {
+    /**
+     * excerpt id
+     */
+    id: number;
+
+    /**
+     * title of the excerpt
+     */
+    title: string;
+
+    parts: { name: string; instrumentId: string; }[];
+
+    /**
+     * whether the part score exists (created on first use, freed by `evictExcerpt`)
+     */
+    created: boolean;
+}
+
 /**
  * The score metadata
  */
@@ -77,6 +77,34 @@ export const readData = (ptr) => {
     return data
 }
 
+/**
+ * read multiple blobs packed in one length-prefixed buffer (`packBlobs` in web/main.cpp)
+ * @param {number} ptr 
+ * @param {boolean} text decode the blobs as UTF-8 strings
+ * @returns {Uint8Array[] | string[]}
+ */
+export const readBlobs = (ptr, text = false) => {
+    let offset = ptr + 8 + 4  // 8 bytes padding, the size of the whole buffer
+
+    const count = Module.getValue(offset, 'i32')
+    offset += 4
+
+    const blobs = []
+    for (let i = 0; i < count; i++) {
+        const size = Module.getValue(offset, 'i32')
+        offset += 4
+        blobs.push(text
+            ? Module.UTF8ToString(offset, size)
+            : new Uint8Array(Module.HEAPU8.subarray(offset, offset + size))  // make a copy
+        )
+        offset += size
+    }
+
+    freePtr(ptr)
+
+    return blobs
+}
+
 /**
  * free a pointer
  * @param {number} bufPtr 
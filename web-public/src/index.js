@@ -7,6 +7,7 @@ import {
     getStrPtr,
     getTypedArrayPtr,
     readData,
+    readBlobs,
     freePtr,
     FileError,
 } from './helper.js'
@@ -171,6 +172,11 @@ class WebMscore {
         // side effects: the soundfont is shared across all instances
         Module['FS_createDataFile']('/', 'MuseScore_General.sf3', data, true, true)
 
+        // drop the soundfont parsed from the old file
+        const pathptr = getStrPtr('/MuseScore_General.sf3')
+        Module.ccall('setSoundFont', null, ['number'], [pathptr])
+        freePtr(pathptr)
+
         WebMscore.hasSoundfont = true
     }
 
@@ -202,13 +208,35 @@ class WebMscore {
     }
 
     /**
-     * Generate excerpts from Parts (only parts that are visible) if no existing excerpts
+     * Generate excerpts from Parts (only parts that are visible) if no existing excerpts  
+     * (the part score of an excerpt is created when its excerptId is first used)
      * @returns {Promise<void>}
      */
     async generateExcerpts() {
         return Module.ccall('generateExcerpts', null, ['number'], [this.scoreptr])
     }
 
+    /**
+     * List the excerpts, without creating their part scores
+     * @returns {Promise<import('../schemas').ExcerptInfo[]>}
+     */
+    async listExcerpts() {
+        const strptr = Module.ccall('listExcerpts', 'number', ['number'], [this.scoreptr])
+        const str = Module.UTF8ToString(strptr + 8)  // 8 bytes of padding
+        freePtr(strptr)
+        return JSON.parse(str)
+    }
+
+    /**
+     * Free the part score of a generated excerpt (e.g. after exporting it),
+     * it is created again if the excerpt is used later
+     * @param {number} id excerpt id
+     * @returns {Promise<boolean>} false for excerpts from the score file, which are kept
+     */
+    async evictExcerpt(id) {
+        return Module.ccall('evictExcerpt', 'boolean', ['number', 'number'], [this.scoreptr, id])
+    }
+
     /**
      * Get the score title
      * @returns {Promise<string>}
@@ -313,6 +341,37 @@ class WebMscore {
         return data
     }
 
+    /**
+     * SVG export: write each distinct glyph outline (noteheads, accidentals, clefs, text...)
+     * once to `<defs>`, and reference it with `<use>` (smaller files)  
+     * side effects: the setting is shared across all instances
+     * @param {boolean} on 
+     */
+    async setSvgGlyphDefs(on) {
+        Module.ccall('setSvgGlyphDefs', null, ['boolean'], [on])
+    }
+
+    /**
+     * Audio export (`saveAudio`): normalize the volume, so that the peak is just below full scale  
+     * The whole song is then kept in memory (~10.6 MB per minute) until its peak is known,
+     * otherwise it is encoded as it is synthesized (default: on)  
+     * side effects: the setting is shared across all instances
+     * @param {boolean} on 
+     */
+    async setAudioNormalize(on) {
+        Module.ccall('setAudioNormalize', null, ['boolean'], [on])
+    }
+
+    /**
+     * The number of threads for MIDI rendering, audio encoding, `saveSvgAll`, `savePngAll` and `saveExcerptPdfs`, 0 for one per core  
+     * (only with the pthreads build, `make release-threads`, no effect otherwise)  
+     * side effects: the thread pool is shared across all instances
+     * @param {number} threads integer
+     */
+    async setRenderThreads(threads) {
+        Module.ccall('setRenderThreads', null, ['number'], [threads])
+    }
+
     /**
      * Export score as the PNG file of one page
      * @param {number} pageNumber integer
@@ -329,6 +388,35 @@ class WebMscore {
         return readData(dataptr)
     }
 
+    /**
+     * Export every page as SVG files, in one call (the score is laid out once)
+     * @param {boolean} drawPageBackground 
+     * @returns {Promise<string[]>} contents of the SVG files (plain text)
+     */
+    async saveSvgAll(drawPageBackground = false) {
+        const dataptr = Module.ccall('saveSvgAll',
+            'number',
+            ['number', 'boolean', 'number'],
+            [this.scoreptr, drawPageBackground, this.excerptId]
+        )
+        return /** @type {string[]} */ (readBlobs(dataptr, true))
+    }
+
+    /**
+     * Export every page as PNG images, in one call
+     * @param {boolean} drawPageBackground 
+     * @param {boolean} transparent
+     * @returns {Promise<Uint8Array[]>}
+     */
+    async savePngAll(drawPageBackground = false, transparent = true) {
+        const dataptr = Module.ccall('savePngAll',
+            'number',
+            ['number', 'boolean', 'boolean', 'number'],
+            [this.scoreptr, drawPageBackground, transparent, this.excerptId]
+        )
+        return /** @type {Uint8Array[]} */ (readBlobs(dataptr))
+    }
+
     /**
      * Export score as PDF file
      * @returns {Promise<Uint8Array>}
@@ -338,6 +426,16 @@ class WebMscore {
         return readData(dataptr)
     }
 
+    /**
+     * Export every excerpt (part) as PDF file, in one call (printed in parallel, see `setRenderThreads`)  
+     * regardless of the excerpt set by `setExcerptId`
+     * @returns {Promise<Uint8Array[]>} in the order of `listExcerpts()`
+     */
+    async saveExcerptPdfs() {
+        const dataptr = Module.ccall('saveExcerptPdfs', 'number', ['number'], [this.scoreptr])
+        return /** @type {Uint8Array[]} */ (readBlobs(dataptr))
+    }
+
     /**
      * Export score as MIDI file
      * @param {boolean} midiExpandRepeats 
@@ -362,7 +460,8 @@ class WebMscore {
     }
 
     /**
-     * Export score as audio file (wav/ogg/flac/mp3)
+     * Export score as audio file (wav/ogg/flac/mp3)  
+     * (normalized unless `setAudioNormalize(false)`)
      * @param {'wav' | 'ogg' | 'flac' | 'mp3'} format 
      */
     async saveAudio(format) {
@@ -380,6 +479,54 @@ class WebMscore {
         return readData(dataptr)
     }
 
+    /**
+     * Export score as audio file (wav/ogg/flac/mp3), and hand out the encoded data progressively  
+     * Only ogg is handed out while encoding, the other formats are handed out in one chunk at the end  
+     * (The output is not normalized, see `saveAudio`)
+     * @param {'wav' | 'ogg' | 'flac' | 'mp3'} format 
+     * @param {(chunk: Uint8Array) => void | Promise<void>} onChunk called with each piece of the encoded file, in order
+     * @returns {Promise<void>}
+     */
+    async encodeAudioStream(format, onChunk) {
+        const fnptr = await this._encodeAudio(format)
+
+        // the iterator function has the same signature as the synthAudio one
+        for (; ;) {
+            const { done, chunk } = await this.processSynth(fnptr)
+            if (chunk.length) {
+                await onChunk(chunk)
+            }
+            if (done) break
+        }
+    }
+
+    /**
+     * Encode audio progressively
+     * @private
+     * @param {'wav' | 'ogg' | 'flac' | 'mp3'} format 
+     * @returns {Promise<number>} Pointer to the iterator function, see `processSynth`
+     */
+    async _encodeAudio(format) {
+        if (!WebMscore.hasSoundfont) {
+            throw new Error('The soundfont is not set.')
+        }
+
+        const fileformatptr = getStrPtr(format)
+        const iteratorFnPtr = Module.ccall('encodeAudio',
+            'number',
+            ['number', 'number', 'number'],
+            [this.scoreptr, fileformatptr, this.excerptId]
+        )
+        freePtr(fileformatptr)
+
+        const success = iteratorFnPtr !== 0
+        if (!success) {
+            throw new Error('encodeAudio: Internal Error.')
+        }
+
+        return iteratorFnPtr
+    }
+
     /**
      * Synthesize audio frames
      * 
@@ -130,13 +130,31 @@ class WebMscoreW {
     }
 
     /**
-     * Generate excerpts from Parts (only parts that are visible) if no existing excerpts
+     * Generate excerpts from Parts (only parts that are visible) if no existing excerpts  
+     * (the part score of an excerpt is created when its excerptId is first used)
      * @returns {Promise<void>}
      */
     generateExcerpts() {
         return this.rpc('generateExcerpts')
     }
 
+    /**
+     * List the excerpts, without creating their part scores
+     * @returns {Promise<import('../schemas').ExcerptInfo[]>}
+     */
+    listExcerpts() {
+        return this.rpc('listExcerpts')
+    }
+
+    /**
+     * Free the part score of a generated excerpt (e.g. after exporting it)
+     * @param {number} id excerpt id
+     * @returns {Promise<boolean>} false for excerpts from the score file, which are kept
+     */
+    evictExcerpt(id) {
+        return this.rpc('evictExcerpt', [id])
+    }
+
     /**
      * Get the score title
      * @returns {Promise<string>}
@@ -220,6 +238,30 @@ class WebMscoreW {
         return this.rpc('saveSvg', [pageNumber, drawPageBackground])
     }
 
+    /**
+     * SVG export: each distinct glyph outline once in `<defs>`, referenced by `<use>`
+     * @param {boolean} on 
+     */
+    async setSvgGlyphDefs(on) {
+        await this.rpc('setSvgGlyphDefs', [on])
+    }
+
+    /**
+     * Audio export: normalize the volume, buffering the whole song until its peak is known (on by default)
+     * @param {boolean} on 
+     */
+    async setAudioNormalize(on) {
+        await this.rpc('setAudioNormalize', [on])
+    }
+
+    /**
+     * The number of threads for MIDI rendering, audio encoding, `saveSvgAll`, `savePngAll` and `saveExcerptPdfs`, 0 for one per core (pthreads build only)
+     * @param {number} threads integer
+     */
+    async setRenderThreads(threads) {
+        await this.rpc('setRenderThreads', [threads])
+    }
+
     /**
      * Export score as the PNG file of one page
      * @param {number} pageNumber integer
@@ -231,6 +273,25 @@ class WebMscoreW {
         return this.rpc('savePng', [pageNumber, drawPageBackground, transparent])
     }
 
+    /**
+     * Export every page as SVG files, in one call
+     * @param {boolean} drawPageBackground 
+     * @returns {Promise<string[]>}
+     */
+    saveSvgAll(drawPageBackground = false) {
+        return this.rpc('saveSvgAll', [drawPageBackground])
+    }
+
+    /**
+     * Export every page as PNG images, in one call
+     * @param {boolean} drawPageBackground 
+     * @param {boolean} transparent
+     * @returns {Promise<Uint8Array[]>}
+     */
+    savePngAll(drawPageBackground = false, transparent = true) {
+        return this.rpc('savePngAll', [drawPageBackground, transparent])
+    }
+
     /**
      * Export score as PDF file
      * @returns {Promise<Uint8Array>}
@@ -239,6 +300,14 @@ class WebMscoreW {
         return this.rpc('savePdf')
     }
 
+    /**
+     * Export every excerpt (part) as PDF file, in one call
+     * @returns {Promise<Uint8Array[]>} in the order of `listExcerpts()`
+     */
+    saveExcerptPdfs() {
+        return this.rpc('saveExcerptPdfs')
+    }
+
     /**
      * Export score as MIDI file
      * @param {boolean} midiExpandRepeats 
@@ -266,6 +335,24 @@ class WebMscoreW {
         return this.rpc('saveAudio', [format])
     }
 
+    /**
+     * Export score as audio file (wav/ogg/flac/mp3), and hand out the encoded data progressively
+     * @param {'wav' | 'ogg' | 'flac' | 'mp3'} format 
+     * @param {(chunk: Uint8Array) => void | Promise<void>} onChunk
+     * @returns {Promise<void>}
+     */
+    async encodeAudioStream(format, onChunk) {
+        const fnptr = await this.rpc('_encodeAudio', [format])
+        for (; ;) {
+            /** @type {import('../schemas').SynthRes} */
+            const { done, chunk } = await this.rpc('processSynth', [fnptr, false])
+            if (chunk.length) {
+                await onChunk(chunk)
+            }
+            if (done) break
+        }
+    }
+
     /**
      * Export positions of measures or segments (if `ofSegments` == true) as JSON string
      * @param {boolean} ofSegments
@@ -0,0 +1,209 @@
+/**
+ * webmscore-cli, batch conversion with the native libwebmscore
+ *
+ * usage: webmscore-cli [-r rounds] [-s soundfont] [-g] [-n] [-j threads] <input file> <output file>...
+ *
+ * The output format is determined by the file extension:
+ *   svg, png (every page, `name-<n>.ext` if there is more than 1 page), pdf, mid, midi,
+ *   mxl, musicxml, xml, mscz, mscx, wav, ogg, flac, mp3,
+ *   metajson (metadata), mpos (measure positions), spos (segment positions)
+ *
+ * With `-r`, the conversion is repeated, and the timing (and the startup time and memory) is printed to stderr
+ * With `-g`, SVG glyph outlines are written once to <defs>, and referenced by <use>
+ * With `-n`, audio is not normalized, it is encoded as it is synthesized instead of buffered until its peak is known
+ * With `-j`, MIDI rendering and audio encoding use that many threads (0: one per core)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "webmscore.h"
+
+/**
+ * the length of data returned by the save* functions (see webmscore.h)
+ */
+static uint32_t dataSize(const char* data) {
+    uint32_t size;
+    memcpy(&size, data + 8, 4);
+    return size;
+}
+
+static bool writeFile(const std::string& path, const char* data, size_t size) {
+    std::ofstream f(path, std::ios::binary);
+    f.write(data, size);
+    return f.good();
+}
+
+/**
+ * write binary (length-prefixed) data to the file, and free it
+ * (nullptr: the export failed)
+ */
+static bool writeBinary(const std::string& path, const char* data) {
+    if (!data)
+        return false;
+    bool ok = writeFile(path, data + 12, dataSize(data));
+    free((void*)data);
+    return ok;
+}
+
+/**
+ * write text data to the file, and free it
+ */
+static bool writeText(const std::string& path, const char* data) {
+    if (!data)
+        return false;
+    bool ok = writeFile(path, data + 8, strlen(data + 8));
+    free((void*)data);
+    return ok;
+}
+
+/**
+ * resident memory in kB (Linux only, 0 otherwise)
+ */
+static long residentKB() {
+#ifdef __linux__
+    long size, pages;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+    const bool ok = fscanf(f, "%ld %ld", &size, &pages) == 2;
+    fclose(f);
+    return ok ? pages * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+#else
+    return 0;
+#endif
+}
+
+static std::string extension(const std::string& path) {
+    size_t i = path.rfind('.');
+    return i == std::string::npos ? "" : path.substr(i + 1);
+}
+
+/**
+ * `name-<n>.ext` for page n (1-based) if there are multiple pages
+ */
+static std::string pagePath(const std::string& path, int page, int npages) {
+    if (npages == 1)
+        return path;
+    size_t i = path.rfind('.');
+    return path.substr(0, i) + "-" + std::to_string(page + 1) + path.substr(i);
+}
+
+static bool convert(uintptr_t score, const std::string& out) {
+    const std::string ext = extension(out);
+    if (ext == "svg" || ext == "png") {
+        // all pages in one call
+        const char* data = ext == "svg" ? saveSvgAll(score, true, -1) : savePngAll(score, true, false, -1);
+        if (!data)
+            return false;
+        const char* p = data + 12;
+        int32_t n;
+        memcpy(&n, p, 4);
+        p += 4;
+        bool ok = true;
+        for (int i = 0; i < n; ++i) {
+            int32_t size;
+            memcpy(&size, p, 4);
+            ok &= writeFile(pagePath(out, i, n), p + 4, size);
+            p += 4 + size;
+        }
+        free((void*)data);
+        return ok;
+    }
+    if (ext == "pdf")
+        return writeBinary(out, savePdf(score, -1));
+    if (ext == "mid" || ext == "midi")
+        return writeBinary(out, saveMidi(score, true, true, -1));
+    if (ext == "mxl")
+        return writeBinary(out, saveMxl(score, -1));
+    if (ext == "musicxml" || ext == "xml")
+        return writeText(out, saveXml(score, -1));
+    if (ext == "mscz" || ext == "mscx")
+        return writeBinary(out, saveMsc(score, ext == "mscz", -1));
+    if (ext == "wav" || ext == "ogg" || ext == "flac" || ext == "mp3")
+        return writeBinary(out, saveAudio(score, ext.c_str(), -1));
+    if (ext == "metajson")
+        return writeText(out, saveMetadata(score));
+    if (ext == "mpos" || ext == "spos")
+        return writeText(out, savePositions(score, ext == "spos", -1));
+
+    fprintf(stderr, "unknown output format <%s>\n", out.c_str());
+    return false;
+}
+
+int main(int argc, char** argv) {
+    int rounds = 0;
+    const char* soundfont = nullptr;
+    bool glyphDefs = false;
+    bool normalize = true;
+    int threads = 1;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            rounds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            soundfont = argv[++i];
+        else if (!strcmp(argv[i], "-g"))
+            glyphDefs = true;
+        else if (!strcmp(argv[i], "-n"))
+            normalize = false;
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.size() < 2) {
+        fprintf(stderr, "usage: %s [-r rounds] [-s soundfont] [-g] [-n] [-j threads] <input file> <output file>...\n", argv[0]);
+        return 1;
+    }
+
+    const auto tInit = std::chrono::steady_clock::now();
+    init(argc, argv);
+    const std::chrono::duration<double, std::milli> initTime = std::chrono::steady_clock::now() - tInit;
+    const long initRss = residentKB();
+    if (soundfont)
+        setSoundFont(soundfont);
+    setSvgGlyphDefs(glyphDefs);
+    setAudioNormalize(normalize);
+    setRenderThreads(threads);
+
+    std::ifstream in(files[0], std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "cannot open <%s>\n", files[0].c_str());
+        return 1;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::string format = extension(files[0]);
+
+    bool ok = true;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int round = 0; round < std::max(rounds, 1); ++round) {
+        uintptr_t score = load(format.c_str(), data.data(), data.size(), true);
+        if (score < 16) {  // Score::FileError
+            fprintf(stderr, "cannot load <%s>, error %d\n", files[0].c_str(), int(score));
+            return 1;
+        }
+        for (size_t i = 1; i < files.size(); ++i)
+            ok &= convert(score, files[i]);
+        destroy(score);
+    }
+    const std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - t0;
+
+    if (rounds) {
+        fprintf(stderr, "init: %f ms, resident memory after init: %ld kB\n", initTime.count(), initRss);
+        fprintf(stderr, "rounds: %d, total: %f ms, avg: %f ms\n", rounds, total.count(), total.count() / rounds);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -1,41 +1,88 @@
 
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
+#else
+// the native build exports the same functions from libwebmscore, see webmscore.h
+#define EMSCRIPTEN_KEEPALIVE __attribute__((visibility("default"), used))
+#endif
 
 #include "libmscore/excerpt.h"
 #include "libmscore/part.h"
 #include "libmscore/importexports.h"
 #include "libmscore/mscore.h"
 #include "libmscore/score.h"
+#include "libmscore/taskpool.h"
 #include "libmscore/text.h"
 #include "libmscore/undo.h"
+#include "mscore/globals.h"
 #include "mscore/preferences.h"
+#include "audio/midi/fluid/fluid.h"
+#include "web/webmscore.h"
 
 /**
  * helper functions
  */
 
+/**
+ * copy the data into a malloc'ed buffer, after 8 bytes of padding,
+ * the caller owns the buffer (`freePtr` in JS, `free` natively)
+ */
+const char* allocData(const QByteArray& data) {
+    char* buf = (char*)malloc(8 + data.size() + 1);
+    memset(buf, 0, 8);  // padding
+    memcpy(buf + 8, data.constData(), data.size() + 1);  // keep the '\0', so strings can be read directly
+    return buf;
+}
+
 /**
  * pack length-prefixed data
  */
-QByteArray packData(QByteArray data, qint64 size) {
+const char* packData(QByteArray data, qint64 size) {
     QByteArray sizeData = QByteArray((const char*)&size, 4);
+    return allocData(sizeData + data);
+}
 
-    QBuffer result;
-    result.open(QIODevice::ReadWrite);
-    result.write(QByteArray(8, '\0'));  // padding
-    result.write(sizeData);
-    result.write(data);
-    result.close();
+/**
+ * padded data (a '\0' terminated string)
+ */
+const char* padData(QByteArray data) {
+    return allocData(data);
+}
 
-    return result.data();
+/**
+ * pack multiple blobs into one length-prefixed buffer,
+ * the blob count, then the length-prefixed blobs
+ */
+const char* packBlobs(const QList<QByteArray>& blobs) {
+    QByteArray data;
+    const int32_t count = blobs.size();
+    data.append((const char*)&count, 4);
+    for (const QByteArray& blob : blobs) {
+        const int32_t size = blob.size();
+        data.append((const char*)&size, 4);
+        data.append(blob);
+    }
+    return packData(data, data.size());
 }
 
 /**
- * It's so weird that the first 8 bytes of data would be overwritten by some random things
- * @todo PLEASE HELP - I'm not familiar with emscripten
+ * scores whose excerpts were generated by `_generateExcerpts` (not read from the file),
+ * their part scores can be freed and created again
  */
-QByteArray padData(QByteArray data) {
-    return QByteArray(8, '\0').append(data);
+static QSet<Ms::MasterScore*> generatedExcerpts;
+
+/**
+ * the part score of the excerpt, created from the master score on first use
+ */
+Ms::Score* excerptPartScore(Ms::Excerpt* e) {
+    if (!e->partScore()) {
+        auto nscore = new Ms::Score(e->oscore());
+        e->setPartScore(nscore);
+        nscore->style().set(Ms::Sid::createMultiMeasureRests, true);
+        Ms::Excerpt::createExcerpt(e);
+        qDebug("createExcerpt: %s", qPrintable(e->title()));
+    }
+    return e->partScore();
 }
 
 Ms::Score* maybeUseExcerpt(Ms::Score* score, int excerptId) {
@@ -47,7 +94,7 @@ Ms::Score* maybeUseExcerpt(Ms::Score* score, int excerptId) {
             throw(QString("Not a valid excerptId."));
         }
 
-        score = excerpts[excerptId]->partScore();
+        score = excerptPartScore(excerpts[excerptId]);
         qDebug("useExcerpt: %d", excerptId);
     }
 
@@ -65,6 +112,12 @@ int _version() {
  * init libmscore
  */
 void _init(int argc, char** argv) {
+#ifndef __EMSCRIPTEN__
+    // headless
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
     new QGuiApplication(argc, argv);
 
     Ms::preferences.init();
@@ -88,6 +141,45 @@ bool _addFont(const char* fontPath) {
     }
 }
 
+/**
+ * set the path of the soundfont (sf2/sf3) file for audio export,
+ * the JS side writes the soundfont to the default path instead (and calls this after writing it);
+ * the parsed soundfonts are shared by all exports until this is called again
+ */
+void _setSoundFont(const char* path) {
+    FluidS::Fluid::soundFontPath = QString::fromUtf8(path);
+    FluidS::Fluid::clearSoundFontCache();
+}
+
+/**
+ * SVG export: write each distinct glyph outline (noteheads, accidentals, clefs, text...)
+ * once to <defs>, and reference it with <use>, instead of a full <path> every time
+ */
+void _setSvgGlyphDefs(bool on) {
+    Ms::svgGlyphDefs = on;
+}
+
+/**
+ * audio export (saveAudio): normalize the volume, so that the peak is just below full scale (on by default)
+ * the whole song is buffered (~10.6 MB per minute) until its peak is known,
+ * turn it off to encode the audio as it is synthesized
+ */
+static bool audioNormalize = true;
+
+void _setAudioNormalize(bool on) {
+    audioNormalize = on;
+}
+
+/**
+ * the size of the shared worker pool (Ms::TaskPool), 0 for one thread per core;
+ * used for MIDI rendering (MIDI, audio export, synthAudio), audio encoding,
+ * SVG pages (saveSvgAll), PNG encoding (savePngAll) and part PDFs (saveExcerptPdfs),
+ * no effect without thread support (WEBMSCORE_THREADS)
+ */
+void _setRenderThreads(int threads) {
+    Ms::TaskPool::instance()->setThreads(threads);
+}
+
 /**
  * load the score data (a MSCZ/MSCX file buffer)
  */
@@ -99,37 +191,30 @@ uintptr_t _load(const char* format, const char* data, const uint32_t size, bool
     MasterScore* score = new MasterScore(MScore::baseStyle());
     score->setMovements(new Movements());
 
-    // create a temporary file, and write `data` into it
-    QTemporaryFile tempfile("XXXXXX." + _format);  // filename template for the temporary file
-    if (!tempfile.open()) { // a QTemporaryFile will always be opened in `QIODevice::ReadWrite` mode
-        throw QString("Cannot create a temporary file");
-    } else {
-        tempfile.write(data, size);
-        tempfile.close(); // calls QFileDevice::flush() and closes the file
-    }
-    QString name = tempfile.fileName(); // temporary filename
+    // read directly from the caller's memory, without copying `data` into a (temporary) file
+    QByteArray rawData = QByteArray::fromRawData(data, size);
+    QBuffer buffer(&rawData);
+    buffer.open(QIODevice::ReadOnly);
+    QString name = "score." + _format; // only used to determine the file type
 
     // mtest/testutils.cpp#L108-L134 readCreatedScore
     // mscore/file.cpp#L2320 readScore
     Score::FileError rv;
     if (_format == "mscz" || _format == "mscx")
-        rv = score->loadMsc(name, true);
+        rv = score->loadMsc(name, &buffer, true);
     else if (_format == "mxl")
-        rv = importCompressedMusicXml(score, name);
+        rv = importCompressedMusicXml(score, &buffer, name);
     else if (_format == "xml" || _format == "musicxml")
-        rv = importMusicXml(score, name);
+        rv = importMusicXml(score, &buffer, name);
     else if (_format == "midi" || _format == "kar")
-        rv = importMidi(score, name);
+        rv = importMidi(score, &buffer, name);
     else if (_format == "gtp" || _format == "gp3" || _format == "gp4" || _format == "gp5" || _format == "gpx" || _format == "gp" || _format == "ptb")
-        rv = importGTP(score, name);
+        rv = importGTP(score, &buffer, name);
     else {
         qWarning("Invalid file format");
         rv = Score::FileError::FILE_UNKNOWN_TYPE;
     }
 
-    // delete the temporary file
-    tempfile.remove();
-
     // handle exceptions
     if (rv != Score::FileError::FILE_NO_ERROR) {
         return char(rv);
@@ -163,37 +248,93 @@ uintptr_t _load(const char* format, const char* data, const uint32_t size, bool
 
 /**
  * Generate excerpts from Parts (only parts that are visible) if no existing excerpts
+ *
+ * Only the excerpt list (titles, parts) is created here,
+ * the part score of an excerpt is created when its excerptId is first used
  */
 void _generateExcerpts(uintptr_t score_ptr) {
     auto score = reinterpret_cast<Ms::MasterScore*>(score_ptr);
 
-    QList<Ms::Excerpt*> scoreExcerpts = score->excerpts();
-    if (scoreExcerpts.size() > 0) {
+    if (score->excerpts().size() > 0) {
         // has existing excerpts
         return;
     }
 
     auto excerpts = Ms::Excerpt::createAllExcerpt(score);
+    score->excerpts().append(excerpts);
+    score->setExcerptsChanged(true);
+    generatedExcerpts.insert(score);
 
-    for (auto e : excerpts) {
-        auto nscore = new Ms::Score(e->oscore());
-        e->setPartScore(nscore);
-        nscore->style().set(Ms::Sid::createMultiMeasureRests, true);
-        auto excerptCmdFake = new Ms::AddExcerpt(e);
-        excerptCmdFake->redo(nullptr);
-        Ms::Excerpt::createExcerpt(e);
+    qDebug("Generated excerpts: size %d", excerpts.size());
+}
 
-        // add this excerpt back to the score excerpt list
-        scoreExcerpts.append(e);
+/**
+ * list the excerpts (id, title, parts, whether the part score exists),
+ * without creating their part scores
+ */
+const char* _listExcerpts(uintptr_t score_ptr) {
+    auto score = reinterpret_cast<Ms::MasterScore*>(score_ptr);
+
+    QJsonArray list;
+    const QList<Ms::Excerpt*>& excerpts = score->excerpts();
+    for (int i = 0; i < excerpts.size(); ++i) {
+        Ms::Excerpt* e = excerpts[i];
+        QJsonArray parts;
+        for (Ms::Part* p : e->parts()) {
+            QJsonObject part;
+            part.insert("name", p->longName().replace("\n", ""));
+            part.insert("instrumentId", p->instrumentId());
+            parts.append(part);
+        }
+        QJsonObject excerpt;
+        excerpt.insert("id", i);
+        excerpt.insert("title", e->title());
+        excerpt.insert("parts", parts);
+        excerpt.insert("created", e->partScore() != nullptr);
+        list.append(excerpt);
     }
 
-    qDebug("Generated excerpts: size %d", excerpts.size());
+    return padData(
+        QJsonDocument(list).toJson(QJsonDocument::Compact)
+    );
+}
+
+/**
+ * free the part score of a generated excerpt (e.g. after it has been exported),
+ * it is created again if the excerptId is used later;
+ * returns false for excerpts read from the file, which are kept
+ *
+ * not while an `encodeAudio`/`synthAudio` iterator of the excerpt is in use
+ */
+bool _evictExcerpt(uintptr_t score_ptr, int excerptId) {
+    auto score = reinterpret_cast<Ms::MasterScore*>(score_ptr);
+
+    QList<Ms::Excerpt*> excerpts = score->excerpts();
+    if (excerptId < 0 || excerptId >= excerpts.size()) {
+        throw(QString("Not a valid excerptId."));
+    }
+    if (!generatedExcerpts.contains(score)) {
+        return false;
+    }
+
+    excerpts[excerptId]->deletePartScore();
+    qDebug("evictExcerpt: %d", excerptId);
+    return true;
+}
+
+/**
+ * destroy the score, and all its excerpts
+ */
+void _destroy(uintptr_t score_ptr) {
+    auto score = reinterpret_cast<Ms::MasterScore*>(score_ptr);
+    generatedExcerpts.remove(score);
+    delete score;
 }
 
 /**
  * get the score title
  */
-QByteArray _title(uintptr_t score_ptr) {
+const char* _title(uintptr_t score_ptr) {
     Ms::MasterScore* score = reinterpret_cast<Ms::MasterScore*>(score_ptr);
 
     // code from MuseScore::saveMetadataJSON
@@ -265,6 +406,11 @@ const char* _saveMsc(uintptr_t score_ptr, bool compressed, int excerptId) {
     auto score = reinterpret_cast<Ms::Score*>(score_ptr);
     score = maybeUseExcerpt(score, excerptId);
 
+    if (score->isMaster()) {  // the file contains all parts
+        for (Ms::Excerpt* e : score->excerpts())
+            excerptPartScore(e);
+    }
+
     if (!score->isMaster()) {  // clone metaTags from masterScore
         QMapIterator<QString, QString> j(score->masterScore()->metaTags());
         while (j.hasNext()) {
@@ -341,6 +487,34 @@ const char* _savePng(uintptr_t score_ptr, int pageNumber, bool drawPageBackgroun
     return packData(buffer.data(), size);
 }
 
+/**
+ * export all pages as SVG files in one call, see `packBlobs`
+ */
+const char* _saveSvgAll(uintptr_t score_ptr, bool drawPageBackground, int excerptId) {
+    auto score = reinterpret_cast<Ms::Score*>(score_ptr);
+    score = maybeUseExcerpt(score, excerptId);
+
+    score->switchToPageMode();
+    QList<QByteArray> svgs = Ms::saveSvgAll(score, drawPageBackground);
+    qDebug("saveSvgAll: excerpt %d, %d pages", excerptId, svgs.size());
+
+    return packBlobs(svgs);
+}
+
+/**
+ * export all pages as PNG images in one call, see `packBlobs`
+ */
+const char* _savePngAll(uintptr_t score_ptr, bool drawPageBackground, bool transparent, int excerptId) {
+    auto score = reinterpret_cast<Ms::Score*>(score_ptr);
+    score = maybeUseExcerpt(score, excerptId);
+
+    score->switchToPageMode();
+    QList<QByteArray> pngs = Ms::savePngAll(score, drawPageBackground, transparent);
+    qDebug("savePngAll: excerpt %d, drawPageBackground %d, transparent %d, %d pages", excerptId, drawPageBackground, transparent, pngs.size());
+
+    return packBlobs(pngs);
+}
+
 /**
  * export score as PDF
  */
@@ -359,6 +533,22 @@ const char* _savePdf(uintptr_t score_ptr, int excerptId) {
     return packData(buffer.data(), size);
 }
 
+/**
+ * export every excerpt as PDF in one call, in excerpt order, see `packBlobs`;
+ * the part scores are created one after another, then printed in parallel
+ */
+const char* _saveExcerptPdfs(uintptr_t score_ptr) {
+    auto score = reinterpret_cast<Ms::Score*>(score_ptr);
+
+    QList<Ms::Score*> scores;
+    for (Ms::Excerpt* e : score->excerpts())
+        scores.append(excerptPartScore(e));
+    QList<QByteArray> pdfs = Ms::savePdfAll(scores);
+    qDebug("saveExcerptPdfs: %d excerpts", pdfs.size());
+
+    return packBlobs(pdfs);
+}
+
 /**
  * export score as MIDI
  */
@@ -391,23 +581,35 @@ const char* _saveAudio(uintptr_t score_ptr, const char* format, int excerptId) {
         throw QString("Invalid output format");
     }
 
-    // save audio data to a temporary file
-    QTemporaryFile tempfile("XXXXXX." + _format);  // filename template for the temporary file
-    if (!tempfile.open()) {
-        throw QString("Cannot create a temporary file");
+    QByteArray data;
+    if (!Ms::encodeAudio(score, _format, &data, audioNormalize)) {
+        throw QString("saveAudio failed");
     }
 
-    auto filename = tempfile.fileName();
-    Ms::saveAudio(score, filename);
+    auto size = data.size();
+    qDebug("saveAudio: excerpt %d, size %d", excerptId, size);
+
+    return packData(data, size);
+}
+
+/**
+ * encode audio progressively,
+ * the iterator function returns the encoded data in SynthRes chunks (see `processSynth`)
+ */
+uintptr_t _encodeAudio(uintptr_t score_ptr, const char* format, int excerptId) {
+    auto score = reinterpret_cast<Ms::Score*>(score_ptr);
+    score = maybeUseExcerpt(score, excerptId);
 
-    auto size = tempfile.size();
-    auto data = tempfile.readAll();
-    qDebug("saveAudio: excerpt %d, tempfile %s, size %lld", excerptId, qPrintable(filename), size);
+    QString _format = QString::fromUtf8(format);
+    if (!(_format == "wav" || _format == "ogg" || _format == "flac" || _format == "mp3")) {
+        throw QString("Invalid output format");
+    }
 
-    // delete the temporary file
-    tempfile.remove();
+    qDebug("encodeAudio: excerpt %d, format %s", excerptId, format);
 
-    return packData(data, size);
+    score->encodeFn = Ms::encodeAudioWorklet(score, _format);
+
+    return score->encodeFn == nullptr ? 0 : reinterpret_cast<uintptr_t>(&score->encodeFn);
 }
 
 /**
@@ -473,6 +675,28 @@ const char* _saveMetadata(uintptr_t score_ptr) {
     );
 }
 
+/**
+ * errors are thrown as QString, the wasm module hands them over to JS as exceptions;
+ * in the native build no exception may cross the C API,
+ * so they are caught and logged, and the call returns `failed` instead
+ */
+template<typename Fn, typename T>
+static auto guarded(Fn fn, T failed) -> decltype(fn()) {
+#ifdef __EMSCRIPTEN__
+    Q_UNUSED(failed);
+    return fn();
+#else
+    try {
+        return fn();
+    } catch (const QString& e) {
+        qWarning("webmscore: %s", qPrintable(e));
+    } catch (const std::exception& e) {
+        qWarning("webmscore: %s", e.what());
+    }
+    return failed;
+#endif
+}
+
 /**
  * export functions (can only be C functions)
  */
@@ -493,6 +717,26 @@ extern "C" {
         return _addFont(fontPath);
     };
 
+    EMSCRIPTEN_KEEPALIVE
+    void setSoundFont(const char* path) {
+        return _setSoundFont(path);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    void setSvgGlyphDefs(bool on) {
+        return _setSvgGlyphDefs(on);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    void setAudioNormalize(bool on) {
+        return _setAudioNormalize(on);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    void setRenderThreads(int threads) {
+        return _setRenderThreads(threads);
+    };
+
     EMSCRIPTEN_KEEPALIVE
     uintptr_t load(const char* format, const char* data, const uint32_t size, bool doLayout = true) {
         return _load(format, data, size, doLayout);
@@ -503,6 +747,16 @@ extern "C" {
         return _generateExcerpts(score_ptr);
     };
 
+    EMSCRIPTEN_KEEPALIVE
+    const char* listExcerpts(uintptr_t score_ptr) {
+        return _listExcerpts(score_ptr);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    bool evictExcerpt(uintptr_t score_ptr, int excerptId) {
+        return guarded([&] { return _evictExcerpt(score_ptr, excerptId); }, false);
+    };
+
     EMSCRIPTEN_KEEPALIVE
     const char* title(uintptr_t score_ptr) {
         return _title(score_ptr);
@@ -510,52 +764,72 @@ extern "C" {
 
     EMSCRIPTEN_KEEPALIVE
     int npages(uintptr_t score_ptr, int excerptId) {
-        return _npages(score_ptr, excerptId);
+        return guarded([&] { return _npages(score_ptr, excerptId); }, -1);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveXml(uintptr_t score_ptr, int excerptId = -1) {
-        return _saveXml(score_ptr, excerptId);
+        return guarded([&] { return _saveXml(score_ptr, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveMxl(uintptr_t score_ptr, int excerptId = -1) {
-        return _saveMxl(score_ptr, excerptId);
+        return guarded([&] { return _saveMxl(score_ptr, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveMsc(uintptr_t score_ptr, bool compressed, int excerptId = -1) {
-        return _saveMsc(score_ptr, compressed, excerptId);
+        return guarded([&] { return _saveMsc(score_ptr, compressed, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveSvg(uintptr_t score_ptr, int pageNumber, bool drawPageBackground, int excerptId = -1) {
-        return _saveSvg(score_ptr, pageNumber, drawPageBackground, excerptId);
+        return guarded([&] { return _saveSvg(score_ptr, pageNumber, drawPageBackground, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* savePng(uintptr_t score_ptr, int pageNumber, bool drawPageBackground, bool transparent, int excerptId = -1) {
-        return _savePng(score_ptr, pageNumber, drawPageBackground, transparent, excerptId);
+        return guarded([&] { return _savePng(score_ptr, pageNumber, drawPageBackground, transparent, excerptId); }, nullptr);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    const char* saveSvgAll(uintptr_t score_ptr, bool drawPageBackground, int excerptId = -1) {
+        return guarded([&] { return _saveSvgAll(score_ptr, drawPageBackground, excerptId); }, nullptr);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    const char* savePngAll(uintptr_t score_ptr, bool drawPageBackground, bool transparent, int excerptId = -1) {
+        return guarded([&] { return _savePngAll(score_ptr, drawPageBackground, transparent, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* savePdf(uintptr_t score_ptr, int excerptId = -1) {
-        return _savePdf(score_ptr, excerptId);
+        return guarded([&] { return _savePdf(score_ptr, excerptId); }, nullptr);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    const char* saveExcerptPdfs(uintptr_t score_ptr) {
+        return _saveExcerptPdfs(score_ptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveMidi(uintptr_t score_ptr, bool midiExpandRepeats, bool exportRPNs, int excerptId = -1) {
-        return _saveMidi(score_ptr, midiExpandRepeats, exportRPNs, excerptId);
+        return guarded([&] { return _saveMidi(score_ptr, midiExpandRepeats, exportRPNs, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
     const char* saveAudio(uintptr_t score_ptr, const char* format, int excerptId = -1) {
-        return _saveAudio(score_ptr, format, excerptId);
+        return guarded([&] { return _saveAudio(score_ptr, format, excerptId); }, nullptr);
+    };
+
+    EMSCRIPTEN_KEEPALIVE
+    uintptr_t encodeAudio(uintptr_t score_ptr, const char* format, int excerptId = -1) {
+        return guarded([&] { return _encodeAudio(score_ptr, format, excerptId); }, 0);
     };
 
     EMSCRIPTEN_KEEPALIVE
     uintptr_t synthAudio(uintptr_t score_ptr, float starttime, int excerptId = -1) {
-        return _synthAudio(score_ptr, starttime, excerptId);
+        return guarded([&] { return _synthAudio(score_ptr, starttime, excerptId); }, 0);
     };
 
     EMSCRIPTEN_KEEPALIVE
@@ -570,7 +844,7 @@ extern "C" {
 
     EMSCRIPTEN_KEEPALIVE
     const char* savePositions(uintptr_t score_ptr, bool ofSegments, int excerptId = -1) {
-        return _savePositions(score_ptr, ofSegments, excerptId);
+        return guarded([&] { return _savePositions(score_ptr, ofSegments, excerptId); }, nullptr);
     };
 
     EMSCRIPTEN_KEEPALIVE
@@ -580,7 +854,7 @@ extern "C" {
 
     EMSCRIPTEN_KEEPALIVE
     void destroy(uintptr_t score_ptr) {
-        delete (Ms::MasterScore*)score_ptr;
+        return _destroy(score_ptr);
     };
 
 }
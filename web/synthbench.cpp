@@ -0,0 +1,98 @@
+/**
+ * webmscore-synthbench, throughput of the soundfont synthesizer (the voice DSP of audio/midi/fluid)
+ *
+ * usage: webmscore-synthbench [-n notes] [-t seconds] [-i interpolation] [-r restrikes] <soundfont file>
+ *
+ * Holds `notes` (default 128) notes of a looped program (String Ensemble 1, on all channels but the drums)
+ * for `seconds` (default 60) of 44.1 kHz audio, and prints the throughput in voices × seconds rendered
+ * per second of wall time: the number of active voices (a stereo sample takes two) times the length of
+ * each block, summed, over the elapsed time.
+ *
+ * `-i`: 0 (none), 1 (linear), 4 (4th order, default) or 7 (7th order), see audio/midi/simd.h for the
+ * kernels compiled in
+ * `-r`: notes struck again (note off, then note on) before every block of 512 frames, to include the
+ * note on/off handling and the voice stealing (from 256 notes on, as most samples are stereo)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "audio/midi/event.h"
+#include "audio/midi/fluid/fluid.h"
+
+static const int SAMPLE_RATE = 44100;
+static const unsigned BLOCK_FRAMES = 512;
+
+int main(int argc, char** argv) {
+    int notes = 128;
+    double seconds = 60;
+    int interpolation = FluidS::FLUID_INTERP_DEFAULT;
+    int restrikes = 0;
+    const char* soundfont = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            notes = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            interpolation = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            restrikes = atoi(argv[++i]);
+        else
+            soundfont = argv[i];
+    }
+    if (!soundfont || notes <= 0 || seconds <= 0) {
+        fprintf(stderr, "usage: %s [-n notes] [-t seconds] [-i interpolation] [-r restrikes] <soundfont file>\n", argv[0]);
+        return 1;
+    }
+
+    FluidS::Fluid::soundFontPath = QString::fromLocal8Bit(soundfont);
+    FluidS::Fluid fluid;
+    fluid.init(SAMPLE_RATE);
+    if (!fluid.loadSoundFonts(QStringList(FluidS::Fluid::soundFontPath))) {
+        fprintf(stderr, "cannot load <%s>\n", soundfont);
+        return 1;
+    }
+
+    // 15 melodic channels, one key per note
+    for (int ch = 0; ch < 16; ++ch) {
+        if (ch != 9)
+            fluid.play(Ms::PlayEvent(Ms::ME_CONTROLLER, ch, Ms::CTRL_PROGRAM, 48));
+    }
+    fluid.set_interp_method(-1, interpolation);
+    // the i-th note
+    auto strike = [&fluid](int i, int vel) {
+        const int ch = i % 15 < 9 ? i % 15 : i % 15 + 1;
+        fluid.play(Ms::PlayEvent(Ms::ME_NOTEON, ch, 24 + (i / 15) % 96, vel));
+    };
+    for (int i = 0; i < notes; ++i)
+        strike(i, 100);
+
+    std::vector<float> out(BLOCK_FRAMES * 2), effect1(BLOCK_FRAMES * 2), effect2(BLOCK_FRAMES * 2);
+    const long blocks = long(seconds * SAMPLE_RATE / BLOCK_FRAMES);
+    double voiceSeconds = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    int next = 0;
+    for (long b = 0; b < blocks; ++b) {
+        for (int i = 0; i < restrikes; ++i, next = (next + 1) % notes) {
+            strike(next, 0);
+            strike(next, 100);
+        }
+        voiceSeconds += double(fluid.activeVoiceCount()) * BLOCK_FRAMES / SAMPLE_RATE;
+        std::fill(out.begin(), out.end(), 0.0f);
+        std::fill(effect1.begin(), effect1.end(), 0.0f);
+        std::fill(effect2.begin(), effect2.end(), 0.0f);
+        fluid.process(BLOCK_FRAMES, out.data(), effect1.data(), effect2.data());
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t0;
+
+    fprintf(stderr, "notes: %d, interpolation: %d, restrikes: %ld, audio: %f s, voices x seconds: %f\n",
+        notes, interpolation, blocks * restrikes, blocks * double(BLOCK_FRAMES) / SAMPLE_RATE, voiceSeconds);
+    fprintf(stderr, "elapsed: %f s, throughput: %f voices x seconds per second\n",
+        elapsed.count(), voiceSeconds / elapsed.count());
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * C API of libwebmscore, the native (headless) build of webmscore
+ *
+ * Same functions as the wasm module (web/main.cpp),
+ * build with `make native` (cmake -DBUILD_NATIVE=ON)
+ *
+ * Returned data buffers are malloc'ed, and owned by the caller (`free` them):
+ *   - binary data (`saveMxl`, `saveMsc`, `savePng`, `savePdf`, `saveMidi`, `saveAudio`):
+ *     8 bytes of padding, a 4-byte little-endian length, then the data
+ *   - text (`title`, `listExcerpts`, `saveXml`, `saveSvg`, `savePositions`, `saveMetadata`):
+ *     8 bytes of padding, then a '\0' terminated UTF-8 string
+ *
+ * `load` returns the Score::FileError code (< 16) on failure, a score handle otherwise
+ *
+ * No exception leaves these functions. On an error (e.g. an invalid excerptId or audio format,
+ * a failed audio encode), it is logged, and the call returns:
+ *   - `nullptr` for the functions returning data
+ *   - 0 for `encodeAudio` and `synthAudio` (also when there is nothing to synthesize)
+ *   - false for `evictExcerpt`, -1 for `npages`
+ */
+
+#ifndef __WEBMSCORE_H__
+#define __WEBMSCORE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int version();
+
+/**
+ * must be called once, before any other function
+ */
+void init(int argc, char** argv);
+
+bool addFont(const char* fontPath);
+
+/**
+ * path of the soundfont (sf2/sf3) file for audio export
+ */
+void setSoundFont(const char* path);
+
+/**
+ * SVG export: each distinct glyph outline once in <defs>, referenced by <use> (off by default)
+ */
+void setSvgGlyphDefs(bool on);
+
+/**
+ * saveAudio: normalize the volume, buffering the whole song until its peak is known (on by default),
+ * off: the audio is encoded as it is synthesized
+ */
+void setAudioNormalize(bool on);
+
+/**
+ * size of the shared worker pool, used by MIDI rendering (saveMidi, saveAudio, synthAudio...),
+ * audio encoding, saveSvgAll, savePngAll and saveExcerptPdfs, 0 for one thread per core (default 1)
+ */
+void setRenderThreads(int threads);
+
+uintptr_t load(const char* format, const char* data, const uint32_t size, bool doLayout);
+// excerpts are listed right away, their part scores are created when the excerptId is first used
+void generateExcerpts(uintptr_t score_ptr);
+const char* listExcerpts(uintptr_t score_ptr);
+bool evictExcerpt(uintptr_t score_ptr, int excerptId);
+void destroy(uintptr_t score_ptr);
+
+const char* title(uintptr_t score_ptr);
+int npages(uintptr_t score_ptr, int excerptId);
+
+// excerptId: -1 for the full score
+const char* saveXml(uintptr_t score_ptr, int excerptId);
+const char* saveMxl(uintptr_t score_ptr, int excerptId);
+const char* saveMsc(uintptr_t score_ptr, bool compressed, int excerptId);
+const char* saveSvg(uintptr_t score_ptr, int pageNumber, bool drawPageBackground, int excerptId);
+const char* savePng(uintptr_t score_ptr, int pageNumber, bool drawPageBackground, bool transparent, int excerptId);
+// all pages at once: length-prefixed data of (int32 count, then `count` blobs of (int32 length, data))
+const char* saveSvgAll(uintptr_t score_ptr, bool drawPageBackground, int excerptId);
+const char* savePngAll(uintptr_t score_ptr, bool drawPageBackground, bool transparent, int excerptId);
+const char* savePdf(uintptr_t score_ptr, int excerptId);
+// the PDF of every excerpt, in excerpt order, packed like saveSvgAll
+const char* saveExcerptPdfs(uintptr_t score_ptr);
+const char* saveMidi(uintptr_t score_ptr, bool midiExpandRepeats, bool exportRPNs, int excerptId);
+const char* saveAudio(uintptr_t score_ptr, const char* format, int excerptId);
+const char* savePositions(uintptr_t score_ptr, bool ofSegments, int excerptId);
+const char* saveMetadata(uintptr_t score_ptr);
+
+/**
+ * iterators, returning malloc'ed `struct SynthRes` (libmscore/synthres.h) on each `processSynth` call
+ */
+uintptr_t encodeAudio(uintptr_t score_ptr, const char* format, int excerptId);
+uintptr_t synthAudio(uintptr_t score_ptr, float starttime, int excerptId);
+const char* processSynth(uintptr_t fn_ptr, bool cancel);
+const char* processSynthBatch(uintptr_t fn_ptr, int batchSize, bool cancel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif